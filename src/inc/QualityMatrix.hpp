@@ -2,17 +2,21 @@
 #define QUALITY_MATRIX_HPP_
 
 #include "common.hpp"
+#include "soil.hpp"
+#include "soilNoise.hpp"
 
 namespace Harvestor {
 struct QualityMatrix {
     float cx, cy, radius;
     float tileSize;
     std::vector<Tile> tiles;
+    std::vector<SoilSample> soil;  // soil[i] belongs to tiles[i]
 
     QualityMatrix(float _cx, float _cy, float _r, float _tileSize = 6.f) : cx(_cx), cy(_cy), radius(_r), tileSize(_tileSize) {}
 
     std::vector<Tile> generateTiles() {
         tiles.clear();
+        soil.clear();
 
         auto insideCircle = [&](float px, float py) {
             float dx = px - cx;
@@ -22,6 +26,7 @@ struct QualityMatrix {
 
         float startX = cx - radius;
         float startY = cy - radius;
+        const SoilNoise noise;  // coherent soil, keyed by cell
 
         for (float y = startY; y <= cy + radius; y += tileSize) {
             for (float x = startX; x <= cx + radius; x += tileSize) {
@@ -37,21 +42,14 @@ struct QualityMatrix {
                 t.isInsideLand = true;
                 t.hasCrop = false;
 
-                // Random soil factors for diversity
-                t.soilBaseQuality = 0.2f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
-                t.sunlight = 0.2f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
-                t.nutrients = 0.2f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
-                t.pH = 0.2f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
-                t.organicMatter = 0.2f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
-                t.compaction = 0.2f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
-                t.salinity = 0.2f + static_cast<float>(rand()) / RAND_MAX * 0.7f;
-
                 tiles.push_back(t);
+                soil.push_back(noise.sample(std::floor(x / tileSize), std::floor(y / tileSize)));
             }
         }
 
         return tiles;
     }
+
 };
 }  // namespace Harvestor
 
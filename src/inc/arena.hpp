@@ -0,0 +1,74 @@
+#ifndef ARENA_HPP_
+#define ARENA_HPP_
+
+#include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+#include "config.hpp"
+#include "memory.hpp"
+
+namespace Harvestor {
+// ---------------- LayoutArena ----------------
+// Memory for everything that lives exactly as long as one loaded layout: tile and soil storage,
+// pond tiles, per-tile water coverage. A monotonic bump allocator over one retained block, so a
+// layout load is a handful of pointer bumps and switching layouts frees it all in one reset().
+// Deallocation is a no-op; containers that grow while a layout is live (irrigation ponds) only
+// waste arena space until the next reset. When a layout outgrows the block the overflow goes to
+// the heap, and the next reset() regrows the block to the high-water mark so the same layout
+// fits from then on. Containers must be destroyed before reset() and before the arena.
+class LayoutArena : public std::pmr::memory_resource {
+   public:
+    explicit LayoutArena(std::size_t bytes = Config::layoutArenaBytes) { allocateBlock(bytes); }
+
+    LayoutArena(const LayoutArena &) = delete;
+    LayoutArena &operator=(const LayoutArena &) = delete;
+
+    std::pmr::memory_resource *resource() { return this; }
+
+    void reset() {
+        if (used > capacity) {
+            allocateBlock(used + used / 4);
+        } else {
+            pool.reset();
+            pool.emplace(block.get(), capacity, std::pmr::new_delete_resource());
+        }
+        peak = std::max(peak, used);
+        used = 0;
+    }
+
+    std::size_t bytesUsed() const { return used; }      // since the last reset, alignment padding excluded
+    std::size_t blockBytes() const { return capacity; }  // retained block
+    std::size_t peakBytes() const { return std::max(peak, used); }
+
+    // The containers in the arena report their own bytes; this adds the block they leave unused
+    void reportMemory(MemoryReport &report) const { report.add(TileStorage, "layout arena unused", capacity > used ? capacity - used : 0); }
+
+   private:
+    std::unique_ptr<std::byte[]> block;
+    std::size_t capacity = 0;
+    std::optional<std::pmr::monotonic_buffer_resource> pool;
+    std::size_t used = 0, peak = 0;
+
+    void allocateBlock(std::size_t bytes) {
+        pool.reset();
+        block.reset();
+        capacity = std::max<std::size_t>(bytes, 4096);
+        block = std::make_unique<std::byte[]>(capacity);
+        pool.emplace(block.get(), capacity, std::pmr::new_delete_resource());
+    }
+
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        used += bytes;
+        return pool->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+};
+
+}  // namespace Harvestor
+
+#endif
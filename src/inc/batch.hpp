@@ -0,0 +1,275 @@
+#ifndef BATCH_HPP_
+#define BATCH_HPP_
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "headless.hpp"
+
+namespace Harvestor {
+// ---------------- FarmEntry ----------------
+// One manifest line: `name layout.txt [crop]` or `name land.csv water.csv [crop]`. Paths are
+// relative to the manifest; the crop defaults to the first in the registry.
+struct FarmEntry {
+    std::string name;
+    std::string layout;               // layouts/*.txt, or empty for a CSV pair
+    std::string landFile, waterFile;  // input/land.csv and input/water.csv format
+    std::string crop;
+};
+
+// ---------------- BatchRunner ----------------
+// Headless seasons (see Headless::season) over every farm of a manifest, one summary row per farm
+// streamed to a CSV. Every farm is sized before any is loaded (estimateTiles); those below
+// Config::parallelGrowthTiles run side by side, one per worker thread, and larger ones run one at a
+// time afterwards, each stepping its chunks on all threads (Land::updateGrowth). Small-farm workers
+// run their farms' kernels inline (SerialScope), so the batch never has more than Config::threads
+// (or one per core) threads busy. Only the farms being simulated are in memory, so memory is
+// bounded by the worker count times the largest small farm, or one large farm.
+// Every finished row is followed by a line in OUT.journal holding the output size after it. A
+// rerun skips the farms listed there and cuts off anything written after the last entry, so an
+// interrupted batch resumes where it stopped.
+class BatchRunner {
+   public:
+    static std::vector<FarmEntry> readManifest(const std::string &path) {
+        std::vector<FarmEntry> entries;
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open batch manifest: " << path << "\n";
+            return entries;
+        }
+
+        std::filesystem::path dir = std::filesystem::path(path).parent_path();
+        auto resolve = [&](const std::string &p) { return std::filesystem::path(p).is_absolute() ? p : (dir / p).string(); };
+        auto isCsv = [](const std::string &p) { return p.size() > 4 && p.compare(p.size() - 4, 4, ".csv") == 0; };
+
+        std::string line;
+        int lineNo = 0;
+        while (std::getline(file, line)) {
+            lineNo++;
+            std::istringstream ss(line);
+            std::vector<std::string> tokens;
+            for (std::string t; ss >> t;) tokens.push_back(t);
+            if (tokens.empty() || tokens[0][0] == '#') continue;
+            if (tokens.size() < 2) {
+                std::cerr << path << ":" << lineNo << ": expected `name layout.txt [crop]` or `name land.csv water.csv [crop]`\n";
+                continue;
+            }
+
+            FarmEntry entry;
+            entry.name = tokens[0];
+            std::size_t next = 2;
+            if (isCsv(tokens[1])) {
+                if (tokens.size() < 3 || !isCsv(tokens[2])) {
+                    std::cerr << path << ":" << lineNo << ": land CSV without a water CSV\n";
+                    continue;
+                }
+                entry.landFile = resolve(tokens[1]);
+                entry.waterFile = resolve(tokens[2]);
+                next = 3;
+            } else {
+                entry.layout = resolve(tokens[1]);
+            }
+            if (next < tokens.size()) entry.crop = tokens[next];
+            entries.push_back(entry);
+        }
+        return entries;
+    }
+
+    // Runs every farm of `manifest` not yet in `output`'s journal; returns the process exit code
+    int run(const std::string &manifest, const std::string &output) {
+        CropRegistry::get().loadFromFile(Config::cropsFile);
+        std::vector<FarmEntry> entries = readManifest(manifest);
+        if (entries.empty()) {
+            std::cerr << "No farms in batch manifest " << manifest << "\n";
+            return 1;
+        }
+        if (!WeatherStream().open(Config::weatherFile)) return 1;
+        if (!openOutput(output)) return 1;
+
+        std::vector<const FarmEntry *> pending;
+        for (const auto &entry : entries)
+            if (!finished.count(entry.name)) pending.push_back(&entry);
+        std::cout << "Batch: " << entries.size() << " farms, " << entries.size() - pending.size() << " already done, results in " << output << "\n";
+        total = entries.size();
+        done = total - pending.size();
+        start = std::chrono::steady_clock::now();
+
+        std::vector<const FarmEntry *> small, large;
+        for (const FarmEntry *entry : pending) (estimateTiles(*entry) < (std::size_t)Config::parallelGrowthTiles ? small : large).push_back(entry);
+
+        // Small farms side by side
+        int workers = Config::threads > 0 ? Config::threads : (int)std::max(1u, std::thread::hardware_concurrency());
+        std::atomic<std::size_t> next{0};
+        std::vector<std::thread> pool;
+        for (int w = 0; w < workers; w++) {
+            pool.emplace_back([&]() {
+                SerialScope serial;  // this thread is the farm's only one
+                for (std::size_t i; (i = next++) < small.size();) runFarm(*small[i]);
+            });
+        }
+        for (auto &t : pool) t.join();
+
+        // Large farms one at a time, each on every thread
+        for (const FarmEntry *entry : large) runFarm(*entry);
+
+        double hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 3600.0;
+        std::cout << "Batch done: " << ran << " farms in " << std::fixed << std::setprecision(2) << hours * 3600.0 << " s, "
+                  << std::setprecision(0) << ran / std::max(hours, 1e-9) << " farms/hour\n"
+                  << std::defaultfloat;
+        return 0;
+    }
+
+   private:
+    struct Summary {
+        std::string status = "ok";
+        std::size_t tiles = 0;
+        std::string crop;
+        Headless::SeasonRun season;
+        float weatherHours = 0.f;
+        LandStats stats;
+        double meanTtm = 0.0;
+    };
+
+    std::string outputPath;
+    std::ofstream out, journal;
+    std::set<std::string> finished;  // names in the journal
+    std::mutex outputMutex;
+    std::size_t total = 0, done = 0, ran = 0;
+    std::chrono::steady_clock::time_point start;
+
+    // Opens `output` and its journal for appending: resumes after the last journaled row, or starts
+    // both afresh with the CSV header
+    bool openOutput(const std::string &output) {
+        outputPath = output;
+        std::string journalPath = output + ".journal";
+        std::uintmax_t offset = 0;
+        {
+            std::ifstream in(journalPath);
+            std::string line;
+            while (std::getline(in, line) && !in.eof()) {  // the last line is only complete if a newline followed it
+                std::size_t tab = line.find('\t');
+                if (tab == std::string::npos) break;
+                offset = std::stoull(line.substr(0, tab));
+                if (tab + 1 < line.size()) finished.insert(line.substr(tab + 1));
+            }
+        }
+
+        bool resume = offset > 0 && std::filesystem::exists(output) && std::filesystem::file_size(output) >= offset;
+        if (resume) {
+            std::filesystem::resize_file(output, offset);  // drop a row whose journal line never made it
+            std::filesystem::resize_file(journalPath, journalSize(journalPath));
+            out.open(output, std::ios::app);
+            journal.open(journalPath, std::ios::app);
+        } else {
+            finished.clear();
+            out.open(output, std::ios::trunc);
+            journal.open(journalPath, std::ios::trunc);
+            out << "farm,status,tiles,crop,steps,weather_hours,rain_mm,avg_growth,matured_pct,mean_ttm_s,avg_water,avg_soil,wall_s\n";
+            out.flush();
+            journal << std::filesystem::file_size(output) << "\t\n";  // header only
+            journal.flush();
+        }
+        if (!out.is_open() || !journal.is_open()) {
+            std::cerr << "Failed to open batch output " << output << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Bytes of the journal's complete lines
+    static std::uintmax_t journalSize(const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        std::uintmax_t size = 0, pos = 0;
+        for (char c; in.get(c);) {
+            pos++;
+            if (c == '\n') size = pos;
+        }
+        return size;
+    }
+
+    // Land tiles of a farm without loading it: the rows of its land CSV, or the summed area of its
+    // layout's land circles in cells. The latter counts overlaps and ponds too, so it never falls
+    // short and a farm that may be large is never run beside others.
+    static std::size_t estimateTiles(const FarmEntry &entry) {
+        if (entry.layout.empty()) {
+            std::ifstream file(entry.landFile, std::ios::binary);
+            std::size_t lines = 0;
+            char buffer[1 << 16];
+            while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) lines += std::count(buffer, buffer + file.gcount(), '\n');
+            return lines > 0 ? lines - 1 : 0;  // header
+        }
+        FarmLayout layout;
+        if (!FarmLayout::parse(entry.layout, layout)) return 0;
+        double cells = 0.0;
+        for (const auto &shape : layout.shapes) {
+            float r = shape.radius * Config::layoutCellsPerUnit + 1.f;  // cells the edge touches
+            if (shape.kind == LayoutShape::Land) cells += 3.14159265 * r * r;
+        }
+        return (std::size_t)cells;
+    }
+
+    // Simulates one farm and records its row
+    void runFarm(const FarmEntry &entry) {
+        CropRegistry &crops = CropRegistry::get();
+        Summary summary;
+        CropId crop = entry.crop.empty() ? 0 : crops.idOf(entry.crop);
+        if (!crops.valid(crop)) summary.status = "unknown crop";
+
+        LayoutArena arena;
+        std::vector<Land> lands;
+        std::vector<Pond> ponds;
+        if (summary.status == "ok") {
+            if (entry.layout.empty())
+                FarmLoader::loadFromCsv(entry.landFile, entry.waterFile, lands, ponds, crop, arena.resource());
+            else
+                FarmLoader::loadFromFile(entry.layout, lands, ponds, crop, arena.resource());
+            for (const auto &land : lands) summary.tiles += land.tiles.size();
+            if (summary.tiles == 0) summary.status = "no land";
+        }
+
+        if (summary.status == "ok") {
+            summary.crop = crops.name(crop);
+            Simulation sim(lands, ponds);
+            sim.layoutChanged();
+            sim.weather.load(Config::weatherFile);
+            sim.apply({SimCommand::SetSimulate, true});
+            summary.season = Headless::runSeason(sim, [](int) {});
+            summary.weatherHours = sim.state.simTime / Config::weatherHourSeconds;
+
+            double ttm = 0.0;
+            for (const auto &land : lands) {
+                summary.stats += land.stats;
+                for (const auto &tile : land.tiles)
+                    if (tile.hasCrop && tile.timeToMature >= 0.f) ttm += tile.timeToMature;
+            }
+            summary.meanTtm = summary.stats.maturedTiles > 0 ? ttm / summary.stats.maturedTiles : 0.0;
+        }
+        record(entry, summary);
+    }
+
+    void record(const FarmEntry &entry, const Summary &s) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        out << entry.name << "," << s.status << "," << s.tiles << "," << s.crop << "," << s.season.steps << "," << std::fixed << std::setprecision(1)
+            << s.weatherHours << "," << s.season.rain << "," << std::setprecision(4) << s.stats.avgGrowth() << "," << std::setprecision(2)
+            << s.stats.maturedPercentage() << "," << s.meanTtm << "," << std::setprecision(4) << s.stats.avgWater() << "," << s.stats.avgSoil() << ","
+            << std::setprecision(3) << s.season.seconds << "\n"
+            << std::defaultfloat;
+        out.flush();
+        journal << std::filesystem::file_size(outputPath) << "\t" << entry.name << "\n";
+        journal.flush();
+
+        done++;
+        ran++;
+        double hours = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 3600.0;
+        std::cout << "[" << done << "/" << total << "] " << entry.name << ": " << s.status << ", " << s.tiles << " tiles, matured " << std::fixed
+                  << std::setprecision(1) << s.stats.maturedPercentage() << "%, " << std::setprecision(0) << ran / std::max(hours, 1e-9)
+                  << " farms/hour\n"
+                  << std::defaultfloat;
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,414 @@
+#ifndef BENCH_HPP_
+#define BENCH_HPP_
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "checkpoint.hpp"
+#include "cropPlanner.hpp"
+#include "distanceField.hpp"
+#include "irrigation.hpp"
+#include "mapExport.hpp"
+#include "moisture.hpp"
+#include "random.hpp"
+#include "soil.hpp"
+#include "soilNoise.hpp"
+
+namespace Harvestor {
+// ---------------- Bench ----------------
+// Headless micro benchmarks, run from the command line (see main.cpp)
+class Bench {
+   public:
+    // Static soil quality over `tiles` random samples for each storage precision:
+    // throughput, memory per tile and error against the float reference
+    static void soilStorage(int tiles) {
+        std::vector<SoilSample> samples(tiles);
+        for (int i = 0; i < tiles; i++) samples[i] = randomSample(i);
+
+        BasicSoilStore<float> reference;
+        std::vector<float> expected = fill(reference, samples);
+
+        std::cout << "Soil quality kernel, " << tiles << " tiles\n";
+        std::cout << std::left << std::setw(8) << "bits" << std::setw(14) << "bytes/tile" << std::setw(14) << "MB" << std::setw(14) << "Mtiles/s"
+                  << std::setw(14) << "max err" << "mean err\n"
+                  << std::right;
+        report<float>(reference, expected, 32);
+
+        BasicSoilStore<std::uint16_t> store16;
+        fill(store16, samples);
+        report<std::uint16_t>(store16, expected, 16);
+
+        BasicSoilStore<std::uint8_t> store8;
+        fill(store8, samples);
+        report<std::uint8_t>(store8, expected, 8);
+    }
+
+    // Full and incremental checkpoint save plus mmap restore of one square land with ~`tiles` tiles
+    static void checkpoint(int tiles) {
+        CropRegistry::get().loadFromFile(Config::cropsFile);
+        std::vector<Land> lands(1);
+        syntheticLand(lands[0], tiles);
+        lands[0].plantCrops(0);
+
+        const CounterRng rng(RngStream::Bench);
+        for (std::size_t i = 0; i < lands[0].tiles.size(); i++) lands[0].tiles[i].crop.growth = rng.uniform(i, 1);
+
+        const std::string path = "checkpoint_bench.bin";
+        SimState state;
+        state.simTime = 42.f;
+        std::filesystem::remove(path);
+        Checkpoint first, writer, reader;
+
+        auto ms = [](auto start) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+        auto start = std::chrono::steady_clock::now();
+        first.save(path, lands, state);
+        double createMs = ms(start);
+
+        start = std::chrono::steady_clock::now();
+        std::size_t full = writer.save(path, lands, state);  // fresh writer: full rewrite of the existing file
+        double fullMs = ms(start);
+
+        // Touch every 10th chunk, as a partial update would
+        for (std::size_t c = 0; c < lands[0].chunks.size(); c += 10) {
+            auto &chunk = lands[0].chunks[c];
+            for (int i = chunk.range.begin; i < chunk.range.end; i++) lands[0].tiles[i].crop.growth = 1.f;
+            chunk.version++;
+        }
+        start = std::chrono::steady_clock::now();
+        std::size_t partial = writer.save(path, lands, state);
+        double partialMs = ms(start);
+
+        std::vector<float> expected;
+        for (auto &tile : lands[0].tiles) expected.push_back(tile.crop.growth);
+        for (auto &tile : lands[0].tiles) tile.crop.growth = 0.f;
+
+        SimState restored;
+        start = std::chrono::steady_clock::now();
+        bool ok = reader.restore(path, lands, restored);
+        double restoreMs = ms(start);
+        for (std::size_t i = 0; ok && i < expected.size(); i++) ok = lands[0].tiles[i].crop.growth == expected[i];
+        ok = ok && restored.simTime == state.simTime;
+
+        std::cout << "Checkpoint, " << lands[0].tiles.size() << " tiles in " << lands[0].chunks.size() << " chunks, "
+                  << std::filesystem::file_size(path) / (1024.0 * 1024.0) << " MB\n";
+        std::cout << "  first save:       " << std::fixed << std::setprecision(2) << createMs << " ms (new file)\n";
+        std::cout << "  full save:        " << fullMs << " ms (" << full << " tiles)\n";
+        std::cout << "  incremental save: " << partialMs << " ms (" << partial << " tiles)\n";
+        std::cout << "  restore (mmap):   " << restoreMs << " ms, " << (ok ? "state matches" : "MISMATCH") << "\n" << std::defaultfloat;
+        std::filesystem::remove(path);
+    }
+
+    // Growth variability draws: batch API against one call per tile
+    static void counterRng(int count) {
+        const CounterRng rng(RngStream::GrowthNoise);
+        std::vector<float> out(count);
+        auto ms = [](auto start) { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+
+        auto start = std::chrono::steady_clock::now();
+        rng.uniformBatch(0.9f, 1.1f, 0, 1, out.data(), out.size());
+        double batchMs = ms(start);
+
+        bool same = true;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++) same &= rng.uniform(0.9f, 1.1f, i, 1) == out[i];
+        double scalarMs = ms(start);
+
+        std::cout << "Counter RNG (Philox4x32-10), " << count << " draws\n" << std::fixed << std::setprecision(2);
+        std::cout << "  batch:  " << batchMs << " ms (" << count / batchMs / 1e3 << " M/s)\n";
+        std::cout << "  scalar: " << scalarMs << " ms (" << count / scalarMs / 1e3 << " M/s), " << (same ? "identical" : "MISMATCH") << "\n"
+                  << std::defaultfloat;
+    }
+
+    // Irrigation placement on one square land with ~`tiles` tiles and a small pond in a corner
+    static void irrigation(int tiles) {
+        CropRegistry::get().loadFromFile(Config::cropsFile);
+        std::vector<Land> lands(1);
+        syntheticLand(lands[0], tiles);
+        std::vector<Pond> ponds(1);
+        float ts = lands[0].tileSize;
+        ponds[0].addTiles({{0.f, 0.f}, {ts, 0.f}, {0.f, ts}, {ts, ts}});
+
+        auto start = std::chrono::steady_clock::now();
+        FarmGrid grid(lands, ponds);
+        IrrigationOptimizer optimizer(lands, grid, 0);
+        double setupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        IrrigationPlan plan = optimizer.optimize(Config::irrigationSources);
+        double optimizeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Irrigation, " << lands[0].tiles.size() << " tiles, " << plan.candidates << " candidate cells, crop "
+                  << CropRegistry::get().name(0) << "\n" << std::fixed << std::setprecision(2);
+        std::cout << "  setup:    " << setupMs << " ms\n";
+        std::cout << "  optimize: " << optimizeMs << " ms (" << plan.sources.size() << " sources, " << plan.evaluations << " candidate scores, "
+                  << std::max(1u, std::thread::hardware_concurrency()) << " threads)\n";
+        std::cout << "  mean time to mature: " << plan.meanTtmBefore << " s -> " << plan.meanTtmAfter << " s\n";
+        for (auto &p : plan.sources) std::cout << "  source at cell (" << (int)(p.x / ts) << ", " << (int)(p.y / ts) << ")\n";
+        std::cout << std::defaultfloat;
+    }
+
+    // Whole-farm crop assignment on one square land with ~`tiles` tiles and a pond in a corner
+    static void cropPlanner(int tiles) {
+        CropRegistry::get().loadFromFile(Config::cropsFile);
+        std::vector<Land> lands(1);
+        syntheticLand(lands[0], tiles);
+        lands[0].plantCrops(0);  // current crop, for the rotation rule
+        std::vector<Pond> ponds(1);
+        float ts = lands[0].tileSize;
+        ponds[0].addTiles({{0.f, 0.f}, {ts, 0.f}, {0.f, ts}, {ts, ts}});
+
+        auto start = std::chrono::steady_clock::now();
+        FarmGrid grid(lands, ponds);
+        CropPlan plan = CropPlanner(lands, grid).plan();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Crop planner, " << lands[0].tiles.size() << " tiles, " << CropRegistry::get().size() << " crops, " << Config::plannerChains
+                  << " chains\n" << std::fixed << std::setprecision(2);
+        std::cout << "  time:   " << ms << " ms\n";
+        std::cout << "  fields: " << plan.plots << " (" << plan.smallPlots << " below " << Config::plannerMinPlotTiles << " tiles)\n";
+        std::cout << "  mean time to mature: " << plan.meanTtm << " s (unconstrained " << plan.unconstrainedMeanTtm << " s)\n";
+        std::cout << "  rotation conflicts: " << plan.rotationConflicts << ", quotas missed: " << plan.quotaViolations << "\n";
+        for (std::size_t c = 0; c < plan.cropTiles.size(); c++) {
+            if (plan.cropTiles[c] > 0)
+                std::cout << "  " << std::left << std::setw(12) << CropRegistry::get().name((CropId)c) << std::right << plan.cropTiles[c] << " tiles\n";
+        }
+        std::cout << std::defaultfloat;
+    }
+
+    // Moisture stencil on side x side grids (1024 and 4096 when side is 0): time per step for the
+    // cache-blocked sweep at 1, 2, 4, ... threads and for one unblocked sweep over whole rows
+    static void moisture(int side) {
+        std::vector<int> sides = side > 0 ? std::vector<int>{side} : std::vector<int>{1024, 4096};
+        int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+        std::vector<int> threadCounts;
+        for (int t = 1; t < cores; t *= 2) threadCounts.push_back(t);
+        threadCounts.push_back(cores);
+
+        const CounterRng rng(RngStream::Bench);
+        int savedThreads = Config::threads, savedRows = Config::moistureBlockRows, savedCols = Config::moistureBlockCols;
+        constexpr int steps = 10;
+        constexpr float dt = 1.f / 60.f;
+
+        for (int n : sides) {
+            MoistureGrid grid(n, n);
+            for (int y = 0; y < n; y++) {
+                for (int x = 0; x < n; x++) {
+                    std::uint64_t cell = CounterRng::cellKey(x, y);
+                    grid.setSoil(x, y, rng.uniform(cell, 2));
+                    grid.waterAt(x, y) = rng.uniform(cell, 3);
+                }
+            }
+            grid.finalize();
+            double before = grid.total();
+
+            auto run = [&]() {
+                auto start = std::chrono::steady_clock::now();
+                for (int s = 0; s < steps; s++) grid.step(dt);
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / steps;
+            };
+
+            std::cout << "Moisture stencil, " << n << "x" << n << " cells, " << std::fixed << std::setprecision(2) << grid.bytes() / (1024.0 * 1024.0)
+                      << " MB, block " << Config::moistureBlockRows << "x" << Config::moistureBlockCols << "\n";
+            double single = 0.0;
+            for (int t : threadCounts) {
+                Config::threads = t;
+                double ms = run();
+                if (t == 1) single = ms;
+                std::cout << "  " << std::setw(3) << t << " threads: " << std::setw(8) << ms << " ms/step, " << std::setw(8)
+                          << (double)n * n / ms / 1e3 << " Mcells/s, speedup " << single / ms << "x\n";
+            }
+            Config::moistureBlockRows = n;
+            Config::moistureBlockCols = n;
+            Config::threads = 1;
+            std::cout << "  unblocked, 1 thread: " << run() << " ms/step\n";
+            Config::moistureBlockRows = savedRows;
+            Config::moistureBlockCols = savedCols;
+
+            int sweeps = (int)(threadCounts.size() + 1) * steps;
+            std::cout << "  water after " << sweeps << " steps: " << grid.total() / before * 100.0 << "% (evaporation only)\n" << std::defaultfloat;
+        }
+        Config::threads = savedThreads;
+    }
+
+    // Pond distance transform on a side x side grid with ~0.1% pond cells, against the per-tile
+    // scan over pond cells it replaced (timed on a sample of rows)
+    static void distanceField(int side) {
+        const CounterRng rng(RngStream::Bench);
+        std::vector<std::uint8_t> mask((std::size_t)side * side);
+        std::vector<sf::Vector2i> ponds;
+        for (int y = 0; y < side; y++) {
+            for (int x = 0; x < side; x++) {
+                bool pond = rng.uniform(CounterRng::cellKey(x, y), 4) < 0.001f;
+                mask[(std::size_t)y * side + x] = pond;
+                if (pond) ponds.emplace_back(x, y);
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<float> d = DistanceField::squared(mask, side, side);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        int rows = std::min(side, 4);
+        double maxErr = 0.0;
+        start = std::chrono::steady_clock::now();
+        for (int y = 0; y < rows; y++) {
+            for (int x = 0; x < side; x++) {
+                float best = DistanceField::far;
+                for (auto &p : ponds) best = std::min(best, (float)((x - p.x) * (x - p.x) + (y - p.y) * (y - p.y)));
+                maxErr = std::max(maxErr, (double)std::abs(best - d[(std::size_t)y * side + x]));
+            }
+        }
+        double scanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() * side / std::max(1, rows);
+
+        // Exactness on rows past 8192 cells, where q^2 no longer fits a float mantissa: a full check
+        // of a long strip against the scan
+        const int stripWidth = std::max(side, 12288), stripHeight = 16;
+        std::vector<std::uint8_t> strip((std::size_t)stripWidth * stripHeight);
+        std::vector<sf::Vector2i> stripPonds;
+        for (int y = 0; y < stripHeight; y++) {
+            for (int x = 0; x < stripWidth; x++) {
+                bool pond = rng.uniform(CounterRng::cellKey(x, y), 5) < 0.002f;
+                strip[(std::size_t)y * stripWidth + x] = pond;
+                if (pond) stripPonds.emplace_back(x, y);
+            }
+        }
+        std::vector<float> stripD = DistanceField::squared(strip, stripWidth, stripHeight);
+        double stripErr = 0.0;
+        for (int y = 0; y < stripHeight; y++) {
+            for (int x = 0; x < stripWidth; x++) {
+                double best = DistanceField::far;
+                for (auto &p : stripPonds) best = std::min(best, (double)(x - p.x) * (x - p.x) + (double)(y - p.y) * (y - p.y));
+                stripErr = std::max(stripErr, std::abs(best - stripD[(std::size_t)y * stripWidth + x]));
+            }
+        }
+
+        std::cout << "Pond distance transform, " << side << "x" << side << " cells, " << ponds.size() << " pond cells\n" << std::fixed
+                  << std::setprecision(2);
+        std::cout << "  transform: " << ms << " ms (" << (double)side * side / ms / 1e3 << " Mcells/s)\n";
+        std::cout << "  pond scan: " << scanMs << " ms (estimated from " << rows << " rows), max error " << maxErr << "\n";
+        std::cout << "  " << stripWidth << "x" << stripHeight << " strip: max error " << stripErr << " against the scan\n" << std::defaultfloat;
+    }
+
+    // Growth map of one square land of side x side tiles (half planted, random growth) exported as a
+    // PNG mosaic to a temporary folder, removed afterwards
+    static void mapExport(int side) {
+        std::vector<Land> lands(1);
+        syntheticLand(lands[0], side * side);
+        const CounterRng rng(RngStream::Bench);
+        for (std::size_t i = 0; i < lands[0].tiles.size(); i++) {
+            Tile &tile = lands[0].tiles[i];
+            tile.hasCrop = rng.uniform(i, 5) < 0.5f;
+            tile.crop.growth = rng.uniform(i, 6);
+        }
+        FarmGrid grid(lands, std::vector<Pond>());
+
+        std::filesystem::path dir = std::filesystem::temp_directory_path() / "harvestor_map_export";
+        MapExportStats stats = MapExporter(lands, grid).write(dir.string(), MapLayer::Growth);
+        std::error_code error;
+        std::filesystem::remove_all(dir, error);
+
+        std::cout << "Map export, " << side << "x" << side << " tiles at " << Config::exportCellPixels << " px per cell\n" << std::fixed << std::setprecision(2);
+        std::cout << "  " << stats.width << "x" << stats.height << " px in " << stats.tiles << " PNG tiles of " << Config::exportTilePixels << " px: " << stats.seconds
+                  << " s (" << (double)stats.width * stats.height / std::max(stats.seconds, 1e-9) / 1e6 << " Mpixels/s), "
+                  << stats.bufferBytes / 1048576.0 << " MB pixel memory per thread\n"
+                  << std::defaultfloat;
+    }
+
+    // Coherent soil (SoilNoise) for a square grid of about `tiles` tiles straight into a SoilStore on
+    // all threads: throughput, memory, and how alike neighbours and related factors come out
+    static void soilNoise(int tiles) {
+        int side = std::max(2, (int)std::sqrt((double)tiles));
+        SoilStore soil;
+        SoilNoise noise;
+        auto start = std::chrono::steady_clock::now();
+        noise.fillGrid(side, side, soil);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Pearson correlation of factor a at tile i with factor b at tile i + offset, over a sample of rows
+        auto correlation = [&](SoilFactor a, SoilFactor b, std::size_t offset) {
+            double sa = 0, sb = 0, saa = 0, sbb = 0, sab = 0, n = 0;
+            int stride = std::max(1, side / 256);
+            for (int y = 0; y < side; y += stride) {
+                for (int x = 0; x + 1 < side; x++) {
+                    std::size_t i = (std::size_t)y * side + x;
+                    double va = soil.get(i, a), vb = soil.get(i + offset, b);
+                    sa += va, sb += vb, saa += va * va, sbb += vb * vb, sab += va * vb, n++;
+                }
+            }
+            double cov = sab / n - sa / n * sb / n;
+            return cov / std::sqrt(std::max(1e-12, (saa / n - sa / n * sa / n) * (sbb / n - sb / n * sb / n)));
+        };
+
+        std::cout << "Soil noise, " << side << "x" << side << " tiles, " << Config::soilNoiseOctaves << " octaves, " << HARVESTOR_SOIL_BITS
+                  << "-bit storage\n"
+                  << std::fixed << std::setprecision(2);
+        std::cout << "  " << seconds << " s (" << (double)soil.size() / seconds / 1e6 << " Mtiles/s), " << soil.bytes() / 1048576.0 << " MB\n";
+        std::cout << "  neighbour correlation: base quality " << correlation(SoilBase, SoilBase, 1) << ", salinity "
+                  << correlation(Salinity, Salinity, 1) << "\n";
+        std::cout << "  factor correlation: nutrients~organic " << correlation(Nutrients, OrganicMatter, 0) << ", compaction~organic "
+                  << correlation(Compaction, OrganicMatter, 0) << "\n"
+                  << std::defaultfloat;
+    }
+
+   private:
+    static SoilSample randomSample(std::uint64_t i) {
+        const CounterRng rng(RngStream::Bench);
+        auto a = rng.bits(i, 0), b = rng.bits(i, 1);
+        auto unit = [](std::uint32_t v) { return (float)(v >> 8) * (1.f / 16777216.f); };
+        return {unit(a[0]), unit(a[1]), unit(a[2]), unit(a[3]), unit(b[0]), unit(b[1]), unit(b[2])};
+    }
+
+    // Square grid of tiles with uniform random soil, laid out like generateTiles(soilMatrix)
+    static void syntheticLand(Land &land, int tiles) {
+        int side = std::max(1, (int)std::sqrt((double)tiles));
+        std::vector<Tile> ts;
+        std::vector<SoilSample> samples;
+        ts.reserve((std::size_t)side * side);
+        samples.reserve((std::size_t)side * side);
+        for (int y = 0; y < side; y++) {
+            for (int x = 0; x < side; x++) {
+                Tile t;
+                t.position = sf::Vector2f(x * land.tileSize, y * land.tileSize);
+                ts.push_back(t);
+                samples.push_back(randomSample((std::uint64_t)y * side + x));
+            }
+        }
+        land.generateTiles(std::move(ts), samples);
+    }
+
+    template <typename T>
+    static std::vector<float> fill(BasicSoilStore<T> &store, const std::vector<SoilSample> &samples) {
+        store.reserve(samples.size());
+        for (const auto &s : samples) store.push_back(s);
+        std::vector<float> out(samples.size());
+        store.staticQuality(0, samples.size(), out.data());
+        return out;
+    }
+
+    template <typename T>
+    static void report(const BasicSoilStore<T> &store, const std::vector<float> &expected, int bits) {
+        std::vector<float> out(store.size());
+        constexpr int passes = 20;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int p = 0; p < passes; p++) store.staticQuality(0, store.size(), out.data());
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double maxErr = 0.0, sumErr = 0.0;
+        for (std::size_t i = 0; i < out.size(); i++) {
+            double err = std::abs((double)out[i] - expected[i]);
+            maxErr = std::max(maxErr, err);
+            sumErr += err;
+        }
+
+        std::cout << std::left << std::setw(8) << bits << std::setw(14) << store.bytesPerTile() << std::setw(14) << std::fixed
+                  << std::setprecision(2) << store.bytes() / (1024.0 * 1024.0) << std::setw(14) << (double)store.size() * passes / seconds / 1e6
+                  << std::setw(14) << std::scientific << std::setprecision(2) << maxErr << sumErr / std::max<std::size_t>(1, out.size()) << "\n"
+                  << std::right << std::defaultfloat << std::setprecision(6);
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CAMERA_HPP_
+#define CAMERA_HPP_
+
+#include "config.hpp"
+
+namespace Harvestor {
+// ---------------- Camera ----------------
+// World view shown in the area right of the UI panel. Supports drag/keyboard pan and
+// zoom around the cursor.
+class Camera {
+    sf::View view;
+    float screenW, screenH;
+    float viewportX;  // screen x where the world viewport starts
+    float pixelsPerUnit = 1.f;
+
+    bool dragging = false;
+    sf::Vector2i dragLast;
+
+   public:
+    Camera(float screenW, float screenH) : screenW(screenW), screenH(screenH), viewportX(Config::uiPanelWidth) {
+        view.setViewport(sf::FloatRect(viewportX / screenW, 0.f, 1.f - viewportX / screenW, 1.f));
+        view.setSize(screenW - viewportX, screenH);
+        view.setCenter((screenW - viewportX) / 2.f, screenH / 2.f);
+    }
+
+    const sf::View &getView() const { return view; }
+    float getPixelsPerUnit() const { return pixelsPerUnit; }
+
+    sf::FloatRect visibleRect() const {
+        sf::Vector2f size = view.getSize();
+        sf::Vector2f center = view.getCenter();
+        return sf::FloatRect(center.x - size.x / 2.f, center.y - size.y / 2.f, size.x, size.y);
+    }
+
+    bool isInViewport(sf::Vector2i pixel) const { return pixel.x >= viewportX && pixel.x < screenW && pixel.y >= 0 && pixel.y < screenH; }
+
+    sf::Vector2f toWorld(sf::Vector2i pixel) const {
+        sf::Vector2f size = view.getSize();
+        sf::Vector2f center = view.getCenter();
+        return {center.x - size.x / 2.f + (pixel.x - viewportX) / pixelsPerUnit, center.y - size.y / 2.f + pixel.y / pixelsPerUnit};
+    }
+
+    // Zoom so that the whole world rectangle is visible, centered
+    void fitTo(const sf::FloatRect &world) {
+        if (world.width <= 0.f || world.height <= 0.f) return;
+        float vw = screenW - viewportX;
+        setPixelsPerUnit(std::min(vw / world.width, screenH / world.height));
+        view.setCenter(world.left + world.width / 2.f, world.top + world.height / 2.f);
+    }
+
+    // Keeps the world point under `pixel` fixed while zooming
+    void zoomAt(sf::Vector2i pixel, float factor) {
+        sf::Vector2f before = toWorld(pixel);
+        setPixelsPerUnit(pixelsPerUnit * factor);
+        sf::Vector2f after = toWorld(pixel);
+        view.move(before - after);
+    }
+
+    void pan(sf::Vector2f screenDelta) { view.move(screenDelta / pixelsPerUnit); }
+
+    // ---------------- Drag pan ----------------
+    void beginDrag(sf::Vector2i pixel) {
+        dragging = true;
+        dragLast = pixel;
+    }
+
+    void drag(sf::Vector2i pixel) {
+        if (!dragging) return;
+        pan(sf::Vector2f((float)(dragLast.x - pixel.x), (float)(dragLast.y - pixel.y)));
+        dragLast = pixel;
+    }
+
+    void endDrag() { dragging = false; }
+
+    // Continuous arrow-key pan, called once per frame
+    void update(float dt) {
+        sf::Vector2f dir(0.f, 0.f);
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left)) dir.x -= 1.f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right)) dir.x += 1.f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up)) dir.y -= 1.f;
+        if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down)) dir.y += 1.f;
+        if (dir.x != 0.f || dir.y != 0.f) pan(dir * (Config::cameraPanSpeed * dt));
+    }
+
+   private:
+    void setPixelsPerUnit(float ppu) {
+        pixelsPerUnit = std::clamp(ppu, Config::cameraMinPixelsPerUnit, Config::cameraMaxPixelsPerUnit);
+        view.setSize((screenW - viewportX) / pixelsPerUnit, screenH / pixelsPerUnit);
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
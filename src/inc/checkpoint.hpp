@@ -0,0 +1,282 @@
+#ifndef CHECKPOINT_HPP_
+#define CHECKPOINT_HPP_
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HARVESTOR_HAS_MMAP 1
+#endif
+
+#include "land.hpp"
+
+namespace Harvestor {
+// ---------------- SimState ----------------
+// Simulation-wide state outside the tiles
+struct SimState {
+    bool simulate = false;
+    float rainRemaining = 0.f;  // seconds of rain left
+    float simTime = 0.f;        // seconds simulated since Start
+    std::uint64_t step = 0;
+    std::uint64_t seed = Config::seed;  // keys growth and rain draws; restored from checkpoints
+};
+
+// ---------------- MappedFile ----------------
+// Read-only view of a whole file: mmap where available, otherwise read into memory
+class MappedFile {
+    const char *bytes = nullptr;
+    std::size_t length = 0;
+    std::vector<char> fallback;
+
+   public:
+    explicit MappedFile(const std::string &path) {
+#ifdef HARVESTOR_HAS_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *p = ::mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                bytes = (const char *)p;
+                length = (std::size_t)st.st_size;
+            }
+        }
+        ::close(fd);
+#else
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return;
+        fallback.resize((std::size_t)file.tellg());
+        file.seekg(0);
+        if (file.read(fallback.data(), fallback.size())) {
+            bytes = fallback.data();
+            length = fallback.size();
+        }
+#endif
+    }
+
+    ~MappedFile() {
+#ifdef HARVESTOR_HAS_MMAP
+        if (bytes) ::munmap((void *)bytes, length);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *data() const { return bytes; }
+    std::size_t size() const { return length; }
+};
+
+// ---------------- Checkpoint ----------------
+// Binary snapshot of the whole simulation (native endianness):
+//   header | tiles per land | one TileRecord per tile
+// Random draws are keyed by (seed, tile, step), so the seed and step are the whole RNG state.
+// Tiles are stored in Land::tiles order, so every chunk is one contiguous run of records and a
+// save after the first one only rewrites chunks whose version changed since the last save.
+class Checkpoint {
+   public:
+    struct Header {
+        char magic[4] = {'H', 'V', 'C', 'P'};
+        std::uint32_t version = 3;
+        std::uint64_t layoutHash = 0;  // land/chunk structure the records belong to
+        std::uint32_t landCount = 0;
+        std::uint32_t tileCount = 0;
+        std::uint64_t step = 0;
+        std::uint64_t seed = 0;
+        float simTime = 0.f;
+        float rainRemaining = 0.f;
+        std::uint32_t simulate = 0;
+        std::uint32_t reserved = 0;
+    };
+
+    struct TileRecord {
+        float growth;
+        float waterLevel;
+        float soilQuality;
+        float timeToMature;
+        float plantedAt;
+        std::uint8_t cropId;
+        std::uint8_t flags;  // bit 0: hasCrop, bit 1: hasGrown
+        std::uint8_t pad[2];
+    };
+    static_assert(sizeof(TileRecord) == 24, "TileRecord layout must stay stable");
+
+    // Writes the checkpoint. Rewrites only dirty chunks when `path` holds our previous save of
+    // the same layout, otherwise writes the whole file. Returns the number of tiles written.
+    std::size_t save(const std::string &path, std::vector<Land> &lands, const SimState &state) {
+        std::uint64_t hash = layoutHash(lands);
+        bool exists = std::filesystem::exists(path);
+        bool incremental = exists && path == lastPath && hash == lastHash;
+
+        // An existing file is overwritten in place: truncating makes the file system free and
+        // reallocate every block, which costs far more than the write itself
+        std::fstream file;
+        if (exists) file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            incremental = false;
+            file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+        }
+        if (!file.is_open()) {
+            std::cerr << "Failed to open checkpoint file: " << path << "\n";
+            return 0;
+        }
+
+        writeHeader(file, lands, state, hash);
+
+        std::size_t written = 0;
+        std::size_t landBase = 0;
+        for (auto &land : lands) {
+            for (auto &chunk : land.chunks) {
+                if (incremental && chunk.savedVersion == chunk.version) continue;
+                int count = chunk.range.end - chunk.range.begin;
+                encode(land, chunk.range.begin, chunk.range.end);
+                file.seekp((std::streamoff)(dataOffset(lands.size()) + (landBase + chunk.range.begin) * sizeof(TileRecord)));
+                file.write((const char *)records.data(), (std::streamsize)(count * sizeof(TileRecord)));
+                chunk.savedVersion = chunk.version;
+                written += count;
+            }
+            landBase += land.tiles.size();
+        }
+
+        file.close();
+        if (!file) {
+            std::cerr << "Failed to write checkpoint: " << path << "\n";
+            lastPath.clear();
+            return 0;
+        }
+
+        std::size_t fileSize = dataOffset(lands.size()) + landBase * sizeof(TileRecord);
+        std::error_code ec;
+        if (std::filesystem::file_size(path, ec) > fileSize) std::filesystem::resize_file(path, fileSize, ec);  // previous save was larger
+        lastPath = path;
+        lastHash = hash;
+        return written;
+    }
+
+    // Restores tiles and `state` (the RNG seed included) from `path`; the current layout must match the saved one
+    bool restore(const std::string &path, std::vector<Land> &lands, SimState &state) {
+        MappedFile file(path);
+        if (!file.data()) {
+            std::cerr << "Failed to open checkpoint file: " << path << "\n";
+            return false;
+        }
+
+        Header header;
+        if (file.size() < sizeof(Header)) return invalid(path, "truncated header");
+        std::memcpy(&header, file.data(), sizeof(Header));
+        if (std::memcmp(header.magic, Header().magic, 4) != 0 || header.version != Header().version) return invalid(path, "not a checkpoint");
+        if (header.layoutHash != layoutHash(lands) || header.landCount != lands.size()) return invalid(path, "saved for a different layout");
+        std::size_t tileCount = 0;
+        for (auto &land : lands) tileCount += land.tiles.size();
+        if (header.tileCount != tileCount || file.size() < dataOffset(lands.size()) + tileCount * sizeof(TileRecord))
+            return invalid(path, "truncated tile data");
+
+        // Ids index the crop tables, so a file saved with a longer crops.txt must not get that far
+        const TileRecord *record = (const TileRecord *)(file.data() + dataOffset(lands.size()));
+        const CropRegistry &crops = CropRegistry::get();
+        for (std::size_t i = 0; i < tileCount; i++) {
+            bool planted = record[i].flags & 1;  // a planted tile needs a real crop; kNoCrop only marks an empty one
+            if (planted ? !crops.valid(record[i].cropId) : record[i].cropId != kNoCrop && !crops.valid(record[i].cropId))
+                return invalid(path, "crop id not in the crop list");
+        }
+
+        for (auto &land : lands) {
+            for (auto &tile : land.tiles) {
+                tile.crop.growth = record->growth;
+                tile.crop.originalSize = sf::Vector2f(tile.size, tile.size);
+                tile.waterLevel = record->waterLevel;
+                tile.soilQuality = record->soilQuality;
+                tile.timeToMature = record->timeToMature;
+                tile.plantedAt = record->plantedAt;
+                tile.cropId = record->cropId;
+                tile.hasCrop = record->flags & 1;
+                tile.hasGrown = record->flags & 2;
+                record++;
+            }
+            land.tilesChanged();
+            for (auto &chunk : land.chunks) chunk.savedVersion = chunk.version;  // memory matches the file again
+        }
+
+        state.simulate = header.simulate != 0;
+        state.rainRemaining = header.rainRemaining;
+        state.simTime = header.simTime;
+        state.step = header.step;
+        state.seed = header.seed;
+        lastPath = path;
+        lastHash = header.layoutHash;
+        return true;
+    }
+
+   private:
+    std::vector<TileRecord> records;  // encode buffer, reused
+    std::string lastPath;             // file of our last save/restore, valid for incremental saves
+    std::uint64_t lastHash = 0;
+
+    static std::size_t dataOffset(std::size_t landCount) { return sizeof(Header) + landCount * sizeof(std::uint32_t); }
+
+    // FNV-1a over land sizes and chunk ranges
+    static std::uint64_t layoutHash(const std::vector<Land> &lands) {
+        std::uint64_t h = 1469598103934665603ull;
+        auto mix = [&](std::int64_t v) {
+            for (int i = 0; i < 8; i++) {
+                h ^= (std::uint64_t)(v >> (i * 8)) & 0xff;
+                h *= 1099511628211ull;
+            }
+        };
+        mix((std::int64_t)lands.size());
+        for (const auto &land : lands) {
+            mix((std::int64_t)land.tiles.size());
+            for (const auto &chunk : land.chunks) {
+                mix(chunk.range.cell.x);
+                mix(chunk.range.cell.y);
+                mix(chunk.range.end - chunk.range.begin);
+            }
+        }
+        return h;
+    }
+
+    void writeHeader(std::fstream &file, const std::vector<Land> &lands, const SimState &state, std::uint64_t hash) {
+        Header header;
+        header.layoutHash = hash;
+        header.landCount = (std::uint32_t)lands.size();
+        for (const auto &land : lands) header.tileCount += (std::uint32_t)land.tiles.size();
+        header.step = state.step;
+        header.seed = state.seed;
+        header.simTime = state.simTime;
+        header.rainRemaining = state.rainRemaining;
+        header.simulate = state.simulate ? 1 : 0;
+
+        file.seekp(0);
+        file.write((const char *)&header, sizeof(Header));
+        for (const auto &land : lands) {
+            std::uint32_t count = (std::uint32_t)land.tiles.size();
+            file.write((const char *)&count, sizeof(count));
+        }
+    }
+
+    void encode(const Land &land, int begin, int end) {
+        records.resize(end - begin);
+        for (int i = begin; i < end; i++) {
+            const Tile &tile = land.tiles[i];
+            TileRecord &r = records[i - begin];
+            r.growth = tile.crop.growth;
+            r.waterLevel = tile.waterLevel;
+            r.soilQuality = tile.soilQuality;
+            r.timeToMature = tile.timeToMature;
+            r.plantedAt = tile.plantedAt;
+            r.cropId = tile.cropId;
+            r.flags = (tile.hasCrop ? 1 : 0) | (tile.hasGrown ? 2 : 0);
+            r.pad[0] = r.pad[1] = 0;
+        }
+    }
+
+    static bool invalid(const std::string &path, const char *reason) {
+        std::cerr << "Cannot restore checkpoint " << path << ": " << reason << "\n";
+        return false;
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef CHUNK_HPP_
+#define CHUNK_HPP_
+
+#include "config.hpp"
+
+namespace Harvestor {
+// ---------------- ChunkRange ----------------
+// A square block of Config::chunkSize x Config::chunkSize grid cells. Items belonging to the
+// chunk are stored contiguously in their owner's vector as [begin, end).
+struct ChunkRange {
+    sf::Vector2i cell;     // grid cell of the chunk's top-left corner
+    sf::FloatRect bounds;  // world-space extent
+    int begin = 0;
+    int end = 0;
+};
+
+// ---------------- ChunkIndex ----------------
+class ChunkIndex {
+   public:
+    // Grid cell of a world-space position (positions are cell * tileSize)
+    static sf::Vector2i cellOf(const sf::Vector2f &position, float tileSize) {
+        return {(int)std::floor(position.x / tileSize + 0.5f), (int)std::floor(position.y / tileSize + 0.5f)};
+    }
+
+    static sf::Vector2i chunkOf(const sf::Vector2i &cell) {
+        auto floorDiv = [](int a, int b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); };
+        return {floorDiv(cell.x, Config::chunkSize), floorDiv(cell.y, Config::chunkSize)};
+    }
+
+    // Chunk-major order of positions (chunks row by row, stable inside a chunk). Fills `order`
+    // with old indices (new[i] = old[order[i]]) and returns the chunk ranges over the new order.
+    static std::vector<ChunkRange> sortOrder(const std::vector<sf::Vector2f> &positions, float tileSize, std::vector<int> &order) {
+        std::vector<ChunkRange> chunks;
+        order.clear();
+        if (positions.empty()) return chunks;
+
+        std::vector<std::pair<std::int64_t, int>> keyed;
+        keyed.reserve(positions.size());
+        for (int i = 0; i < (int)positions.size(); i++) keyed.emplace_back(key(chunkOf(cellOf(positions[i], tileSize))), i);
+        std::stable_sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+        order.reserve(keyed.size());
+        float chunkWorld = Config::chunkSize * tileSize;
+        for (int i = 0; i < (int)keyed.size(); i++) {
+            if (i == 0 || keyed[i].first != keyed[i - 1].first) {
+                if (!chunks.empty()) chunks.back().end = i;
+                sf::Vector2i c = chunkOf(cellOf(positions[keyed[i].second], tileSize));
+                ChunkRange range;
+                range.cell = {c.x * Config::chunkSize, c.y * Config::chunkSize};
+                range.bounds = sf::FloatRect(range.cell.x * tileSize, range.cell.y * tileSize, chunkWorld, chunkWorld);
+                range.begin = i;
+                chunks.push_back(range);
+            }
+            order.push_back(keyed[i].second);
+        }
+        chunks.back().end = (int)keyed.size();
+        return chunks;
+    }
+
+    // new[i] = old[order[i]], in place, one permutation cycle at a time: the container is never
+    // reallocated, so arena-backed (std::pmr) vectors do not leave a dead copy behind
+    template <typename Vec>
+    static void permute(Vec &items, const std::vector<int> &order) {
+        std::vector<bool> placed(order.size(), false);
+        for (std::size_t start = 0; start < order.size(); start++) {
+            if (placed[start]) continue;
+            auto held = std::move(items[start]);
+            std::size_t i = start;
+            while (true) {
+                placed[i] = true;
+                std::size_t from = (std::size_t)order[i];
+                if (from == start) break;
+                items[i] = std::move(items[from]);
+                i = from;
+            }
+            items[i] = std::move(held);
+        }
+    }
+
+    // Reorders items so that every chunk's items are contiguous and returns the chunk ranges.
+    // posFn(item) must return the item's world-space top-left position.
+    template <typename Vec, typename PosFn>
+    static std::vector<ChunkRange> build(Vec &items, float tileSize, PosFn posFn) {
+        std::vector<sf::Vector2f> positions;
+        positions.reserve(items.size());
+        for (const auto &item : items) positions.push_back(posFn(item));
+
+        std::vector<int> order;
+        auto chunks = sortOrder(positions, tileSize, order);
+        permute(items, order);
+        return chunks;
+    }
+
+   private:
+    // Row-major key: y in the high bits so sorting walks chunks row by row
+    static std::int64_t key(const sf::Vector2i &chunk) { return (std::int64_t)chunk.y * (std::int64_t(1) << 32) + (std::int64_t)(std::uint32_t)(chunk.x + 0x40000000); }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -1,8 +1,12 @@
 #ifndef COMMON_HPP_
 #define COMMON_HPP_
 
+#include "chunk.hpp"
 #include "config.hpp"
+#include "memory.hpp"
 #include "normalizer.hpp"
+#include "random.hpp"
+#include "resources.hpp"
 
 namespace Harvestor {
 
@@ -15,8 +19,11 @@ struct CropType {
     float tolerance;     // how much deviation it can handle
 };
 
+// Interned crop type index into CropRegistry
+using CropId = std::uint8_t;
+constexpr CropId kNoCrop = 255;
+
 struct Crop {
-    sf::RectangleShape shape;
     float growth = 0.f;
     sf::Vector2f originalSize;
 };
@@ -27,7 +34,7 @@ struct Point {
 };
 
 struct CropSimulation {
-    std::string cropName;
+    CropId cropId = kNoCrop;
     float x;
     float y;
     double timeToMature;
@@ -39,27 +46,23 @@ struct Tile {
     float size;
 
     Crop crop;          // current growth, shape, etc.
-    CropType cropType;  // the type of crop planted
-
-    // Soil factors (0..1)
-    float soilBaseQuality;  // fertility
-    float waterLevel;       // current water
-    float sunlight;         // sunlight exposure
-    float nutrients;        // nutrient richness
-    float pH;               // acidity (normalized 0..1)
-    float organicMatter;    // organic content
-    float compaction;       // soil compactness
-    float salinity;         // optional, extra factor
-
-    float soilQuality;  // final computed
+    CropId cropId = kNoCrop;  // the type of crop planted (CropRegistry id)
+
+    // Static soil factors live in Land::soil (SoilStore), indexed like Land::tiles
+    float waterLevel = 0.f;   // current water (0..1)
+    float soilQuality = 0.f;  // final computed
     bool isInsideLand;
 
     bool hasCrop = false;
     bool hasGrown = false;
 
-    float timeToMature = -1.f;  // -1 = not matured yet
+    float plantedAt = 0.f;      // simulation time of planting; this tile's own clock starts here
+    float timeToMature = -1.f;  // seconds from planting to maturity, -1 = not matured yet
 };
 
+// A land's tiles; allocated from the layout's LayoutArena when loaded from a layout
+using TileVector = std::pmr::vector<Tile>;
+
 struct Splash {
     sf::Vector2f position;
     float radius = 1.f;
@@ -120,11 +123,13 @@ class BlobGenerator {
    public:
     static sf::ConvexShape generate(float cx, float cy, float radius, int points = 40, float irregularity = 0.15f) {
         std::vector<sf::Vector2f> rawPoints;
+        const CounterRng rng(RngStream::BlobShape);
+        const std::uint64_t blob = CounterRng::cellKey((int)std::lround(cx), (int)std::lround(cy));  // same blob for the same center
 
         // Step 1: Generate noisy circle points
         for (int i = 0; i < points; i++) {
             float angle = i * 2 * M_PI / points;
-            float r = radius * (1.f - irregularity / 2.f + static_cast<float>(rand()) / RAND_MAX * irregularity);
+            float r = radius * (1.f - irregularity / 2.f + rng.uniform(blob, (std::uint64_t)i) * irregularity);
             rawPoints.emplace_back(cx + r * cos(angle), cy + r * sin(angle));
         }
 
@@ -168,33 +173,34 @@ class Utility {
 };
 
 // ---------------- Pond ----------------
+// One pond cell: a plain tinted square, or the water texture stretched over the tile
+struct PondTile {
+    sf::Vector2f position;  // top-left, world space
+    float size = 0.f;
+    sf::Color color = sf::Color::White;
+    bool textured = false;
+};
+
 class Pond {
    public:
-    std::vector<sf::RectangleShape> tiles;  // Pond tiles
+    std::pmr::vector<PondTile> tiles;  // in the layout's arena, see LayoutArena
+    std::vector<ChunkRange> chunks;    // tiles grouped for visibility culling
     float tileSize;
-    static sf::Texture waterTexture;  // shared texture
-    bool loaded = false;
-
-    Pond(float tileSize = Config::landTileSize) : tileSize(tileSize) {
-        // Load water texture once
-        if (!loaded) {
-            if (!waterTexture.loadFromFile("resources/water.png")) {
-                std::cerr << "Failed to load water texture!" << std::endl;
-            } else {
-                waterTexture.setRepeated(true);
-                waterTexture.setSmooth(true);
-                loaded = true;
-            }
-        }
-    }
+
+    Pond(float tileSize = Config::landTileSize, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+        : tiles(memory), tileSize(tileSize) {}
 
     void generate(const std::vector<sf::Vector2f> &positions) {
         tiles.clear();
+        chunks.clear();
         if (positions.empty()) return;
 
-        Normalizer normalizer(positions);
+        // Same world-space grid mapping as Land tiles
+        Normalizer normalizer(positions, tileSize);
 
         int neighborRadius = 0;  // expand if you want surrounding pond tiles
+        const CounterRng rng(RngStream::PondTint);
+        tiles.reserve(positions.size() * (2 * neighborRadius + 1) * (2 * neighborRadius + 1));
 
         for (auto &pos : positions) {
             sf::Vector2f center = normalizer.normalize(pos);
@@ -204,43 +210,79 @@ class Pond {
                 for (int dy = -neighborRadius; dy <= neighborRadius; dy++) {
                     if (dx == 0 && dy == 0) continue;
 
-                    sf::RectangleShape rect(sf::Vector2f(tileSize, tileSize));
-                    rect.setPosition(center.x + dx * tileSize, center.y + dy * tileSize);
+                    PondTile tile;
+                    tile.position = sf::Vector2f(center.x + dx * tileSize, center.y + dy * tileSize);
+                    tile.size = tileSize;
 
                     // Base bluish tint with variation
                     sf::Color base(60, 160, 210);
-                    int r = base.r + (rand() % 15 - 7);
-                    int g = base.g + (rand() % 15 - 7);
-                    int b = base.b + (rand() % 15 - 7);
+                    std::array<std::uint32_t, 4> tint = rng.bits(CounterRng::cellKey((int)std::lround(pos.x) + dx, (int)std::lround(pos.y) + dy), 0);
+                    int r = base.r + (int)(tint[0] % 15) - 7;
+                    int g = base.g + (int)(tint[1] % 15) - 7;
+                    int b = base.b + (int)(tint[2] % 15) - 7;
 
                     float dist = std::sqrt(dx * dx + dy * dy);
                     float depthFactor = 1.0f - dist * 0.1f;
                     depthFactor = std::clamp(depthFactor, 0.7f, 1.1f);
 
-                    rect.setFillColor(sf::Color(std::clamp(int(r * depthFactor), 0, 255), std::clamp(int(g * depthFactor), 0, 255),
-                                                std::clamp(int(b * depthFactor), 0, 255), 220));
+                    tile.color = sf::Color(std::clamp(int(r * depthFactor), 0, 255), std::clamp(int(g * depthFactor), 0, 255),
+                                           std::clamp(int(b * depthFactor), 0, 255), 220);
 
-                    tiles.push_back(rect);
+                    tiles.push_back(tile);
                 }
             }
 
             // Center tile with texture
-            sf::RectangleShape centerTile(sf::Vector2f(tileSize, tileSize));
-            centerTile.setPosition(center);
-            centerTile.setTexture(&waterTexture);
-            tiles.push_back(centerTile);
+            tiles.push_back(waterTile(center));
         }
 
+        chunks = ChunkIndex::build(tiles, tileSize, [](const PondTile &t) { return t.position; });
         std::cout << "Generated " << tiles.size() << " pond tiles.\n";
     }
 
-    void draw(sf::RenderWindow &window) {
-        for (auto &rect : tiles) {
-            window.draw(rect);
+    // Appends single textured water tiles at world positions (top-left), e.g. placed irrigation sources
+    void addTiles(const std::vector<sf::Vector2f> &worldPositions) {
+        for (auto &pos : worldPositions) tiles.push_back(waterTile(pos));
+        chunks = ChunkIndex::build(tiles, tileSize, [](const PondTile &t) { return t.position; });
+    }
+
+    void reportMemory(MemoryReport &report) const {
+        report.add(TileStorage, "pond tiles", MemoryReport::vectorBytes(tiles) + MemoryReport::vectorBytes(chunks));
+    }
+
+    // Visible tiles go into two quad batches, tinted and textured, drawn with one call each.
+    // Render thread only; the batches are scratch shared by all ponds.
+    void draw(sf::RenderTarget &target, const sf::FloatRect &visible) {
+        static const TextureHandle water = ResourceCache::get().request(Config::waterTexturePath);
+        const sf::Texture *waterTexture = ResourceCache::get().texture(water);  // nullptr while loading
+        static std::array<sf::VertexArray, 2> batches{sf::VertexArray(sf::Quads), sf::VertexArray(sf::Quads)};
+        for (auto &batch : batches) batch.clear();
+        sf::Vector2f texSize = waterTexture ? sf::Vector2f(waterTexture->getSize()) : sf::Vector2f(0.f, 0.f);
+        for (auto &chunk : chunks) {
+            if (!visible.intersects(chunk.bounds)) continue;
+            for (int i = chunk.begin; i < chunk.end; i++) {
+                const PondTile &t = tiles[i];
+                sf::VertexArray &va = batches[t.textured];
+                sf::Vector2f tex = t.textured ? texSize : sf::Vector2f(0.f, 0.f);
+                va.append(sf::Vertex(t.position, t.color, sf::Vector2f(0.f, 0.f)));
+                va.append(sf::Vertex(sf::Vector2f(t.position.x + t.size, t.position.y), t.color, sf::Vector2f(tex.x, 0.f)));
+                va.append(sf::Vertex(t.position + sf::Vector2f(t.size, t.size), t.color, tex));
+                va.append(sf::Vertex(sf::Vector2f(t.position.x, t.position.y + t.size), t.color, sf::Vector2f(0.f, tex.y)));
+            }
         }
+        if (batches[0].getVertexCount() > 0) target.draw(batches[0]);
+        if (batches[1].getVertexCount() > 0) target.draw(batches[1], sf::RenderStates(waterTexture));
+    }
+
+   private:
+    PondTile waterTile(sf::Vector2f position) const {
+        PondTile tile;
+        tile.position = position;
+        tile.size = tileSize;
+        tile.textured = true;
+        return tile;
     }
 };
-sf::Texture Pond::waterTexture;  // shared texture
 
 // Utility functions for RGB <-> HSL
 struct ColorUtils {
@@ -12,6 +12,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory_resource>
 #include <random>
 #include <sstream>
 #include <string>
@@ -30,6 +31,7 @@ struct Config {
     static inline float grassTileSize = 30.f;
     static inline float growthSpeed = 0.15f;
     static inline float uiPanelWidth = 150.f;
+    static inline int statsVerifySteps = 600;  // debug builds: steps between running-stats rescans
 
     // ---------------- Buttons ----------------
     static inline float cropButtonWidth = 130.f;
@@ -57,9 +59,17 @@ struct Config {
     static inline float rainIntensity = 0.5f;    // adjust value as needed
 
     static inline std::string fontPath = "resources/DejaVuSans.ttf";
-    static inline std::string layoutFile = "input/farm_layout.txt";
+    static inline std::string groundTexturePath = "resources/combined.png";  // farmland and grass are crops of it
+    static inline std::string waterTexturePath = "resources/water.png";
+    static inline std::string wheatTexturePath = "resources/wheat1.png";
+    static inline std::string tomatoTexturePath = "resources/tomato.png";
+    static inline std::string sugarcaneTexturePath = "resources/sugarcane.png";
+    static inline std::string landFile = "input/land.csv";    // default farm of the headless runs: soil per tile
+    static inline std::string waterFile = "input/water.csv";  // and its water cells
     static inline std::string cropsFile = "input/crops.txt";
     static inline std::string soilDataFile = "soil_data.csv";
+    static inline std::string checkpointFile = "checkpoint.bin";
+    static inline float startupBudgetMs = 500.f;  // launch to first frame; the startup report flags overruns
 
     // crops
     static inline int maxVisibleCrops = 4;
@@ -68,7 +78,79 @@ struct Config {
     // Raindrops
     static inline int numRaindrops = 2000;
 
-    static inline std::mt19937 rng{12345};
+    // ---------------- World / Camera ----------------
+    static inline int chunkSize = 64;                // tiles per chunk side
+    static inline float lodTilePixels = 4.f;         // below this on-screen tile size, chunks draw their baked texture
+    static inline float lodRebakeInterval = 0.5f;    // seconds between LOD texture refreshes while growing
+    static inline float overlayOpacity = 0.75f;      // heatmap overlay (O key) over the lands
+    static inline float cameraPanSpeed = 800.f;      // screen pixels per second (arrow keys)
+    static inline float cameraZoomStep = 1.15f;      // zoom factor per wheel notch
+    static inline float cameraMinPixelsPerUnit = 0.01f;
+    static inline float cameraMaxPixelsPerUnit = 8.f;
+    static inline std::size_t layoutArenaBytes = 8u << 20;  // initial LayoutArena block; grows to the largest layout loaded
+
+    // ---------------- Planning (irrigation, crop assignment) ----------------
+    static inline float maxTimeToMature = 10000.f;   // seconds; time to maturity of a tile that barely grows
+    static inline int irrigationSources = 3;         // water sources placed per "Irrigate"
+    static inline int irrigationSearchPasses = 3;    // local search passes after the greedy placement
+    static inline int plannerMinPlotTiles = 16;      // smallest contiguous field of one crop
+    static inline float plannerMaxCropShare = 0.4f;  // most of the farm one crop may take
+    static inline bool plannerRotation = true;       // no crop of the same class as the tile's current one
+    static inline int plannerChains = 4;             // parallel annealing chains
+    static inline int plannerSweeps = 400;           // annealing moves per plot and chain
+
+    // ---------------- Weather series ----------------
+    static inline std::string weatherFile = "input/weather.csv";  // hour,rain_mm,temp_c,solar_wm2
+    static inline int weatherLookahead = 256;                     // rows buffered ahead of the current hour
+    static inline float weatherHourSeconds = 1.f;                 // simulated seconds per weather hour
+    static inline float weatherWaterPerMm = 0.05f;                // water level added per mm of rain
+    static inline float weatherEvaporationPerDegree = 0.002f;     // extra evaporation per second per deg C above optimal
+    static inline float weatherOptimalTemp = 22.f;                // deg C of fastest growth
+    static inline float weatherTempTolerance = 15.f;              // deg C from optimal where growth stops
+    static inline float weatherReferenceSolar = 800.f;            // W/m^2 of full-speed growth
+    static inline float weatherNightGrowth = 0.2f;                // growth share left without sunlight
+    static inline float rainFieldCellTiles = 16.f;                // rain cell size in tiles
+    static inline float rainFieldVariation = 0.5f;                // local rain = series rain * (1 +- variation)
+    static inline sf::Vector2f rainFieldDrift = {0.3f, 0.1f};     // rain cells moved per hour
+    static inline float seasonStepSeconds = 0.25f;                // headless --season step
+    static inline float whatIfMaxSeconds = 3600.f;                // headless --what-if gives up on tiles not mature by then
+
+    // ---------------- Moisture transport ----------------
+    static inline bool moistureDiffusion = false;             // lateral flow between neighbouring tiles (D key, --diffusion)
+    static inline float moistureConductivity = 0.2f;          // exchange rate per second between two loose-soil neighbours
+    static inline float moistureCompactionBlock = 0.8f;       // conductivity share lost at full compaction
+    static inline float moistureEvaporation = 0.002f;         // water fraction lost per second on loose soil
+    static inline float moistureCompactionEvaporation = 1.f;  // extra evaporation share at full compaction
+    static inline float moistureMaxCourant = 0.8f;            // sub-step so dt * (outflow rate) stays below this
+    static inline int moistureBlockRows = 16;                 // cache block of the stencil sweep
+    static inline int moistureBlockCols = 1024;
+
+    // ---------------- Map export ----------------
+    static inline std::string exportDir = "";   // --export DIR: map PNGs of the final state of a headless season
+    static inline int exportCellPixels = 4;     // pixels per grid cell
+    static inline int exportTilePixels = 2048;  // side of one PNG of the mosaic; memory is bounded by threads x tile
+
+    static inline int threads = 0;                    // worker threads for parallel kernels, 0 = all cores (--threads N)
+    static inline int parallelGrowthTiles = 1 << 18;  // lands this large step their chunks in parallel
+
+    // ---------------- Generated soil ----------------
+    static inline float soilNoiseFeatureCells = 48.f;  // cells across the largest soil patches
+    static inline int soilNoiseOctaves = 4;            // finer detail layers, each half the size
+    static inline float soilNoisePersistence = 0.5f;   // weight of each layer relative to the previous
+
+    // ---------------- Layout files ----------------
+    static inline float layoutCellsPerUnit = 0.25f;  // grid cells per layouts/*.txt unit
+    static inline int layoutSubsamples = 4;          // scanlines per cell row when measuring coverage
+    static inline float layoutMinCoverage = 0.5f;    // a cell is land or water once this much of it is covered
+
+    // ---------------- Batch runs ----------------
+    static inline std::string batchOutput = "batch_results.csv";  // --batch MANIFEST [OUT]: one summary row per farm, plus OUT.journal
+
+    // ---------------- Simulation thread ----------------
+    static inline float simStepSeconds = 1.f / 60.f;  // target period of a simulation step
+    static inline float simMaxStepSeconds = 0.1f;     // dt clamp after a stall
+
+    static inline std::uint64_t seed = 12345;  // CounterRng seed for every random stream (--seed N)
 
     static inline bool tilesGenerated = false;
 };
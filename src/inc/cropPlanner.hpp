@@ -0,0 +1,310 @@
+#ifndef CROP_PLANNER_HPP_
+#define CROP_PLANNER_HPP_
+
+#include "parallel.hpp"
+#include "random.hpp"
+#include "tileRaster.hpp"
+
+namespace Harvestor {
+// ---------------- CropQuota ----------------
+// Share of the planned tiles (0..1) one crop must / may take
+struct CropQuota {
+    CropId crop = kNoCrop;
+    float minShare = 0.f;
+    float maxShare = 1.f;
+};
+
+struct PlannerOptions {
+    int minPlotTiles = Config::plannerMinPlotTiles;    // smallest contiguous field of one crop
+    float maxCropShare = Config::plannerMaxCropShare;  // cap for crops without a quota
+    std::vector<CropQuota> quotas;
+    bool rotation = Config::plannerRotation;  // never follow a tile's current crop with one of the same class
+    int chains = Config::plannerChains;       // independent annealing runs, best one wins
+    int sweeps = Config::plannerSweeps;       // annealing moves per plot and chain
+};
+
+// ---------------- CropPlan ----------------
+struct CropPlan {
+    std::vector<std::vector<CropId>> crops;  // per land, per tile (indexed like Land::tiles)
+    std::vector<int> cropTiles;              // planned tiles per CropId
+    double meanTtm = 0.0;                    // seconds, steady state (TileRaster::timeToMature)
+    double unconstrainedMeanTtm = 0.0;       // best crop on every tile, ignoring all constraints
+    int plots = 0;                           // contiguous fields
+    int smallPlots = 0;                      // fields below minPlotTiles that could not be merged
+    int rotationConflicts = 0;               // tiles whose crop repeats the class of the current one
+    int quotaViolations = 0;                 // crops outside their share
+};
+
+// ---------------- CropPlanner ----------------
+// Assigns a crop to every land tile to minimize the farm's total time to maturity under planning
+// rules: minimum contiguous plot size, per-crop area quotas and crop rotation.
+// 1. Per-tile x per-crop TTM matrix from the growth model at water equilibrium (parallel over tiles).
+// 2. The grid is cut into square plots of at least minPlotTiles cells, so fields are contiguous
+//    and large enough by construction; each plot costs the sum of its tiles.
+// 3. Simulated annealing over plot assignments with quota penalties; several chains with their own
+//    counter-based random streams run in parallel, so the result only depends on the seed.
+// 4. Fields left below minPlotTiles (irregular land edges) merge into the cheapest neighbour.
+class CropPlanner {
+   public:
+    // `grid` must be built from `lands` and outlive the planner
+    CropPlanner(const std::vector<Land> &lands, const FarmGrid &grid, PlannerOptions options = PlannerOptions())
+        : lands(lands), options(std::move(options)), raster(lands, grid) {}
+
+    CropPlan plan() {
+        CropPlan result;
+        const CropRegistry &registry = CropRegistry::get();
+        numCrops = (int)registry.size();
+        numTiles = (int)raster.tiles.size();
+        result.crops.resize(lands.size());
+        for (std::size_t l = 0; l < lands.size(); l++) result.crops[l].assign(lands[l].tiles.size(), kNoCrop);
+        result.cropTiles.assign(numCrops, 0);
+        if (numTiles == 0 || numCrops == 0) return result;
+
+        buildMatrices();
+        buildQuotas();
+        buildPlots();
+
+        // ---------------- Annealing ----------------
+        int chains = std::max(1, options.chains);
+        std::vector<std::vector<int>> assignments(chains);
+        std::vector<double> energies(chains);
+        parallelFor(
+            chains, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t c = begin; c < end; c++) energies[c] = anneal((std::uint64_t)c, assignments[c]);
+            },
+            1);
+        int best = (int)(std::min_element(energies.begin(), energies.end()) - energies.begin());
+
+        std::vector<CropId> tileCrop(numTiles);
+        for (int t = 0; t < numTiles; t++) tileCrop[t] = (CropId)assignments[best][plotOfCell[raster.tileCell[t]]];
+
+        // ---------------- Repair and report ----------------
+        mergeSmallFields(tileCrop, result);
+
+        double ttmSum = 0.0, bestSum = 0.0;
+        for (int t = 0; t < numTiles; t++) {
+            CropId crop = tileCrop[t];
+            const TileRaster::TileRef &ref = raster.tiles[t];
+            result.crops[ref.land][ref.index] = crop;
+            result.cropTiles[crop]++;
+            ttmSum += ttm[(std::size_t)t * numCrops + crop];
+            bestSum += *std::min_element(ttm.begin() + (std::size_t)t * numCrops, ttm.begin() + (std::size_t)(t + 1) * numCrops);
+            if (cost[(std::size_t)t * numCrops + crop] > ttm[(std::size_t)t * numCrops + crop]) result.rotationConflicts++;
+        }
+        for (int c = 0; c < numCrops; c++) result.quotaViolations += violation(c, result.cropTiles[c]) > 0 ? 1 : 0;
+        result.meanTtm = ttmSum / numTiles;
+        result.unconstrainedMeanTtm = bestSum / numTiles;
+        return result;
+    }
+
+   private:
+    const std::vector<Land> &lands;
+    PlannerOptions options;
+    TileRaster raster;
+    int numCrops = 0, numTiles = 0;
+
+    std::vector<float> ttm;               // [tile * numCrops + crop], raster tile order
+    std::vector<float> cost;              // ttm plus the rotation penalty
+    std::vector<int> minTiles, maxTiles;  // per crop, from the quotas
+    double penalty = 0.0;                 // energy per tile outside a quota
+
+    int numPlots = 0;
+    std::vector<int> plotOfCell;   // grid cell -> plot, -1 for cells without tiles
+    std::vector<double> plotCost;  // [plot * numCrops + crop]
+    std::vector<int> plotTiles;
+    double startTemperature = 1.0;
+
+    static bool sameRotationGroup(CropId previous, CropId next) {
+        const CropRegistry &registry = CropRegistry::get();
+        if (!registry.valid(previous)) return false;
+        if (previous == next) return true;
+        return registry.cropClass[previous] != CropClass::Other && registry.cropClass[previous] == registry.cropClass[next];
+    }
+
+    void buildMatrices() {
+        ttm.resize((std::size_t)numTiles * numCrops);
+        cost.resize(ttm.size());
+        parallelFor(numTiles, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t t = begin; t < end; t++) {
+                const TileRaster::TileRef &ref = raster.tiles[t];
+                const Tile &tile = lands[ref.land].tiles[ref.index];
+                CropId previous = tile.hasCrop ? tile.cropId : kNoCrop;
+                float coverage = raster.grid.pondCoverage[raster.tileCell[t]];
+                for (int c = 0; c < numCrops; c++) {
+                    std::size_t i = t * numCrops + c;
+                    ttm[i] = TileRaster::timeToMature(raster.tileQuality[t], coverage, (CropId)c);
+                    cost[i] = ttm[i] + (options.rotation && sameRotationGroup(previous, (CropId)c) ? Config::maxTimeToMature : 0.f);
+                }
+            }
+        });
+        penalty = Config::maxTimeToMature;
+    }
+
+    void buildQuotas() {
+        minTiles.assign(numCrops, 0);
+        maxTiles.assign(numCrops, (int)std::ceil(options.maxCropShare * numTiles));
+        for (const auto &quota : options.quotas) {
+            if (quota.crop >= numCrops) continue;
+            minTiles[quota.crop] = (int)std::ceil(quota.minShare * numTiles);
+            maxTiles[quota.crop] = (int)std::floor(quota.maxShare * numTiles);
+        }
+    }
+
+    int violation(int crop, int tiles) const { return std::max(0, minTiles[crop] - tiles) + std::max(0, tiles - maxTiles[crop]); }
+
+    // Square plots of side ceil(sqrt(minPlotTiles)) aligned to the raster
+    void buildPlots() {
+        int side = std::max(1, (int)std::ceil(std::sqrt((double)std::max(1, options.minPlotTiles))));
+        int plotsX = (raster.grid.width + side - 1) / side;
+        std::vector<int> plotOfBlock((std::size_t)plotsX * ((raster.grid.height + side - 1) / side), -1);
+        plotOfCell.assign(raster.grid.cells(), -1);
+        for (int y = 0; y < raster.grid.height; y++) {
+            for (int x = 0; x < raster.grid.width; x++) {
+                int c = raster.grid.index(x, y);
+                if (raster.cellStart[c] == raster.cellStart[c + 1]) continue;
+                int &plot = plotOfBlock[(y / side) * plotsX + x / side];
+                if (plot < 0) plot = numPlots++;
+                plotOfCell[c] = plot;
+            }
+        }
+
+        plotCost.assign((std::size_t)numPlots * numCrops, 0.0);
+        plotTiles.assign(numPlots, 0);
+        for (int t = 0; t < numTiles; t++) {
+            int plot = plotOfCell[raster.tileCell[t]];
+            plotTiles[plot]++;
+            for (int c = 0; c < numCrops; c++) plotCost[(std::size_t)plot * numCrops + c] += cost[(std::size_t)t * numCrops + c];
+        }
+
+        // Start hot enough to trade a plot's best crop for its runner-up most of the time
+        double gapSum = 0.0;
+        for (int p = 0; p < numPlots; p++) {
+            const double *row = &plotCost[(std::size_t)p * numCrops];
+            std::vector<double> sorted(row, row + numCrops);
+            std::sort(sorted.begin(), sorted.end());
+            gapSum += numCrops > 1 ? sorted[1] - sorted[0] : 0.0;
+        }
+        startTemperature = std::max(1e-3, gapSum / std::max(1, numPlots));
+    }
+
+    // One annealing chain; returns the energy of the best assignment it saw
+    double anneal(std::uint64_t chain, std::vector<int> &bestAssign) const {
+        std::vector<int> assign(numPlots), area(numCrops, 0);
+        for (int p = 0; p < numPlots; p++) {
+            const double *row = &plotCost[(std::size_t)p * numCrops];
+            assign[p] = (int)(std::min_element(row, row + numCrops) - row);
+            area[assign[p]] += plotTiles[p];
+        }
+        double energy = 0.0;
+        for (int p = 0; p < numPlots; p++) energy += plotCost[(std::size_t)p * numCrops + assign[p]];
+        for (int c = 0; c < numCrops; c++) energy += penalty * violation(c, area[c]);
+        bestAssign = assign;
+        double bestEnergy = energy;
+        if (numCrops < 2) return bestEnergy;
+
+        const CounterRng rng(RngStream::CropPlanner);
+        std::uint64_t moves = (std::uint64_t)numPlots * std::max(1, options.sweeps);
+        double cooling = std::pow(1e-3, 1.0 / (double)moves);  // to 1/1000 of the start temperature
+        double temperature = startTemperature;
+
+        for (std::uint64_t m = 0; m < moves; m++, temperature *= cooling) {
+            std::array<std::uint32_t, 4> r = rng.bits(chain, m);
+            int p = (int)(((std::uint64_t)r[0] * numPlots) >> 32);
+            int from = assign[p];
+            int to = (int)(((std::uint64_t)r[1] * (numCrops - 1)) >> 32);
+            if (to >= from) to++;
+
+            int n = plotTiles[p];
+            double delta = plotCost[(std::size_t)p * numCrops + to] - plotCost[(std::size_t)p * numCrops + from];
+            delta += penalty * (violation(from, area[from] - n) - violation(from, area[from]) + violation(to, area[to] + n) - violation(to, area[to]));
+            if (delta > 0.0 && (float)(r[2] >> 8) * (1.f / 16777216.f) >= std::exp(-delta / temperature)) continue;
+
+            assign[p] = to;
+            area[from] -= n;
+            area[to] += n;
+            energy += delta;
+            if (energy < bestEnergy - 1e-9) {
+                bestEnergy = energy;
+                bestAssign = assign;
+            }
+        }
+        return bestEnergy;
+    }
+
+    // Fields below minPlotTiles (plots cut by the land outline) take the crop of the neighbouring
+    // field that costs least and keeps its quota; labels fields and counts them on the way
+    void mergeSmallFields(std::vector<CropId> &tileCrop, CropPlan &result) const {
+        std::vector<int> area(numCrops, 0);
+        for (int t = 0; t < numTiles; t++) area[tileCrop[t]]++;
+
+        std::vector<int> field(raster.grid.cells(), -1);
+        std::vector<int> queue, members;
+        for (int pass = 0;; pass++) {
+            bool merged = false, canMerge = pass < 4;  // the last pass only labels
+            std::fill(field.begin(), field.end(), -1);
+            result.plots = result.smallPlots = 0;
+
+            for (std::size_t start = 0; start < raster.grid.cells(); start++) {
+                if (field[start] >= 0 || plotOfCell[start] < 0) continue;
+                CropId crop = tileCrop[raster.cellStart[start]];
+
+                // Flood fill one field over 4-neighbours with the same crop
+                queue.assign(1, (int)start);
+                field[start] = result.plots;
+                members.clear();
+                std::vector<int> neighbourCrops;
+                int tiles = 0;
+                while (!queue.empty()) {
+                    int c = queue.back();
+                    queue.pop_back();
+                    members.push_back(c);
+                    tiles += raster.cellStart[c + 1] - raster.cellStart[c];
+                    int x = c % raster.grid.width, y = c / raster.grid.width;
+                    const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+                    for (int d = 0; d < 4; d++) {
+                        if (!raster.grid.inside(x + dx[d], y + dy[d])) continue;
+                        int n = raster.grid.index(x + dx[d], y + dy[d]);
+                        if (plotOfCell[n] < 0) continue;
+                        CropId other = tileCrop[raster.cellStart[n]];
+                        if (other != crop) {
+                            neighbourCrops.push_back(other);
+                        } else if (field[n] < 0) {
+                            field[n] = result.plots;
+                            queue.push_back(n);
+                        }
+                    }
+                }
+                result.plots++;
+                if (tiles >= options.minPlotTiles) continue;
+
+                // Cheapest neighbouring crop that stays within its quota
+                int best = -1;
+                double bestCost = 0.0;
+                for (CropId other : neighbourCrops) {
+                    if (area[other] + tiles > maxTiles[other]) continue;
+                    double c = 0.0;
+                    for (int cell : members)
+                        for (int t = raster.cellStart[cell]; t < raster.cellStart[cell + 1]; t++) c += cost[(std::size_t)t * numCrops + other];
+                    if (best < 0 || c < bestCost) {
+                        best = other;
+                        bestCost = c;
+                    }
+                }
+                if (best < 0 || !canMerge) {
+                    result.smallPlots++;
+                    continue;
+                }
+                for (int cell : members)
+                    for (int t = raster.cellStart[cell]; t < raster.cellStart[cell + 1]; t++) tileCrop[t] = (CropId)best;
+                area[crop] -= tiles;
+                area[best] += tiles;
+                merged = true;
+            }
+            if (!merged) break;
+        }
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef CROP_REGISTRY_HPP_
+#define CROP_REGISTRY_HPP_
+
+#include <utility>
+
+#include "common.hpp"
+
+namespace Harvestor {
+// ---------------- Built-in crops ----------------
+enum class CropClass : std::uint8_t { Grain, Legume, Root, Fruit, Fiber, Cane, Leafy, Other };
+
+// Sprite swapped in when a crop reaches full growth
+enum class MatureSprite : std::uint8_t { None, Wheat, Tomato, Sugarcane };
+
+struct CropSpec {
+    const char *name;
+    float baseGrowthRate;
+    sf::Uint8 r, g, b;
+    float optimalWater;
+    float tolerance;
+    CropClass cropClass;
+    MatureSprite sprite;
+};
+
+// Defaults matching input/crops.txt; used when the file is missing and to pick specialized kernels
+constexpr std::array<CropSpec, 12> kBuiltinCrops = {{
+    {"Wheat", 5.0f, 245, 222, 179, 0.6f, 0.2f, CropClass::Grain, MatureSprite::None},
+    {"Corn", 2.0f, 255, 255, 0, 0.5f, 0.3f, CropClass::Grain, MatureSprite::None},
+    {"Rice", 0.8f, 240, 240, 200, 0.8f, 0.2f, CropClass::Grain, MatureSprite::None},
+    {"Barley", 4.0f, 218, 165, 32, 0.5f, 0.25f, CropClass::Grain, MatureSprite::Wheat},
+    {"Soybean", 1.5f, 34, 139, 34, 0.55f, 0.15f, CropClass::Legume, MatureSprite::None},
+    {"Potato", 0.6f, 210, 180, 140, 0.6f, 0.3f, CropClass::Root, MatureSprite::None},
+    {"Tomato", 1.0f, 255, 99, 71, 0.5f, 0.2f, CropClass::Fruit, MatureSprite::Tomato},
+    {"Carrot", 0.5f, 255, 165, 0, 0.4f, 0.15f, CropClass::Root, MatureSprite::None},
+    {"Cotton", 0.8f, 245, 245, 245, 0.4f, 0.1f, CropClass::Fiber, MatureSprite::None},
+    {"Sugarcane", 20.0f, 50, 205, 50, 0.9f, 0.1f, CropClass::Cane, MatureSprite::Sugarcane},
+    {"Spinach", 3.0f, 0, 128, 0, 0.7f, 0.2f, CropClass::Leafy, MatureSprite::None},
+    {"Lettuce", 2.5f, 144, 238, 144, 0.6f, 0.25f, CropClass::Leafy, MatureSprite::None},
+}};
+
+// ---------------- Growth kernels ----------------
+struct GrowthParams {
+    float baseGrowthRate;
+    float optimalWater;
+    float invTwoTolSq;  // 1 / (2 * tolerance^2)
+};
+
+// Parameters of built-in crop `Builtin` as compile-time constants; a loop instantiated with them
+// has the crop's rate, optimum and tolerance folded in
+template <std::size_t Builtin>
+struct BuiltinGrowthParams {
+    static constexpr float baseGrowthRate = kBuiltinCrops[Builtin].baseGrowthRate;
+    static constexpr float optimalWater = kBuiltinCrops[Builtin].optimalWater;
+    static constexpr float invTwoTolSq = 1.f / (2.f * kBuiltinCrops[Builtin].tolerance * kBuiltinCrops[Builtin].tolerance);
+};
+
+// Growth per second before random variability: speed * rate * soil quality * water stress.
+// `Params` is GrowthParams or a BuiltinGrowthParams<I>.
+template <typename Params>
+inline float growthRate(const Params &p, float soilQuality, float waterLevel) {
+    float waterDiff = waterLevel - p.optimalWater;
+    float waterStress = std::clamp(std::exp(-(waterDiff * waterDiff) * p.invTwoTolSq), 0.f, 1.f);
+    return Config::growthSpeed * p.baseGrowthRate * soilQuality * waterStress;
+}
+
+// ---------------- CropLoader ----------------
+class CropLoader {
+   public:
+    static std::vector<CropType> loadFromFile(const std::string &filename) {
+        std::vector<CropType> crops;
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open crop file: " << filename << "\n";
+            return crops;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;  // skip comments
+            std::istringstream iss(line);
+            CropType crop;
+            int r, g, b;
+            if (iss >> crop.name >> crop.baseGrowthRate >> r >> g >> b >> crop.optimalWater >> crop.tolerance) {
+                crop.baseColor = sf::Color(r, g, b);
+                crops.push_back(crop);
+            } else {
+                std::cerr << "Invalid crop line: " << line << "\n";
+            }
+        }
+        return crops;
+    }
+};
+
+// ---------------- CropRegistry ----------------
+// Crop types loaded once and interned to compact ids; parameters live in dense tables indexed by id.
+class CropRegistry {
+   public:
+    std::vector<std::string> names;
+    std::vector<float> baseGrowthRate;
+    std::vector<float> optimalWater;
+    std::vector<float> tolerance;
+    std::vector<sf::Color> baseColor;
+    std::vector<MatureSprite> matureSprite;
+    std::vector<CropClass> cropClass;  // Other for crops not in the built-in table
+    std::vector<GrowthParams> growthParams;
+    std::vector<std::int8_t> builtin;  // index into kBuiltinCrops when the crop's parameters match one, else -1
+
+    static CropRegistry &get() {
+        static CropRegistry registry;
+        return registry;
+    }
+
+    // Falls back to the built-in table when the file is missing or empty
+    void loadFromFile(const std::string &filename) {
+        clear();
+        auto crops = CropLoader::loadFromFile(filename);
+        if (crops.empty()) {
+            std::cerr << "Using built-in crop table\n";
+            for (const auto &spec : kBuiltinCrops) {
+                crops.push_back({spec.name, spec.baseGrowthRate, sf::Color(spec.r, spec.g, spec.b), spec.optimalWater, spec.tolerance});
+            }
+        }
+        for (const auto &crop : crops) add(crop);
+    }
+
+    CropId add(const CropType &crop) {
+        auto it = ids.find(crop.name);
+        if (it != ids.end()) return it->second;
+        if (names.size() >= kNoCrop) {
+            std::cerr << "Too many crop types, ignoring " << crop.name << "\n";
+            return kNoCrop;
+        }
+
+        CropId id = (CropId)names.size();
+        ids[crop.name] = id;
+        names.push_back(crop.name);
+        baseGrowthRate.push_back(crop.baseGrowthRate);
+        optimalWater.push_back(crop.optimalWater);
+        tolerance.push_back(crop.tolerance);
+        baseColor.push_back(crop.baseColor);
+        growthParams.push_back({crop.baseGrowthRate, crop.optimalWater, 1.f / (2.f * crop.tolerance * crop.tolerance)});
+
+        const CropSpec *spec = builtinSpec(crop.name);
+        matureSprite.push_back(spec ? spec->sprite : MatureSprite::None);
+        cropClass.push_back(spec ? spec->cropClass : CropClass::Other);
+        builtin.push_back(spec && spec->baseGrowthRate == crop.baseGrowthRate && spec->optimalWater == crop.optimalWater &&
+                                  spec->tolerance == crop.tolerance
+                              ? (std::int8_t)(spec - kBuiltinCrops.data())
+                              : (std::int8_t)-1);
+        return id;
+    }
+
+    std::size_t size() const { return names.size(); }
+    bool valid(CropId id) const { return id < names.size(); }
+
+    CropId idOf(const std::string &name) const {
+        auto it = ids.find(name);
+        return it != ids.end() ? it->second : kNoCrop;
+    }
+
+    const std::string &name(CropId id) const {
+        static const std::string unknown = "Unknown Crop";
+        return valid(id) ? names[id] : unknown;
+    }
+
+    float growthRate(CropId id, float soilQuality, float waterLevel) const { return Harvestor::growthRate(growthParams[id], soilQuality, waterLevel); }
+
+    // Calls fn(params) once with the growth parameters of crop `id`: a BuiltinGrowthParams<I> when
+    // the crop matches built-in I, so a loop over a run of its tiles inside `fn` is compiled with
+    // the constants folded in; GrowthParams otherwise. Dispatch once per run, not per tile.
+    template <typename Fn>
+    void withGrowthParams(CropId id, Fn &&fn) const {
+        dispatchBuiltin(builtin[id], growthParams[id], fn, std::make_index_sequence<kBuiltinCrops.size()>{});
+    }
+
+   private:
+    std::unordered_map<std::string, CropId> ids;
+
+    void clear() {
+        names.clear();
+        baseGrowthRate.clear();
+        optimalWater.clear();
+        tolerance.clear();
+        baseColor.clear();
+        matureSprite.clear();
+        cropClass.clear();
+        growthParams.clear();
+        builtin.clear();
+        ids.clear();
+    }
+
+    template <typename Fn, std::size_t... I>
+    static void dispatchBuiltin(int index, const GrowthParams &params, Fn &fn, std::index_sequence<I...>) {
+        bool found = ((index == (int)I ? (fn(BuiltinGrowthParams<I>{}), true) : false) || ...);
+        if (!found) fn(params);
+    }
+
+    static const CropSpec *builtinSpec(const std::string &name) {
+        for (const auto &spec : kBuiltinCrops)
+            if (name == spec.name) return &spec;
+        return nullptr;
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
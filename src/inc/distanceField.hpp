@@ -0,0 +1,97 @@
+#ifndef DISTANCE_FIELD_HPP_
+#define DISTANCE_FIELD_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace Harvestor {
+// ---------------- DistanceField ----------------
+// Exact Euclidean distance transform (Felzenszwalb & Huttenlocher): squared distance, in cells,
+// from every cell of a row-major width x height grid to the nearest set cell of `mask`. Two passes
+// of the 1D lower-envelope transform, first down every column and then along every row, so the
+// cost is O(width * height) whatever the number of set cells. Columns and rows are independent and
+// spread over all cores. Cells with no set cell anywhere get DistanceField::far.
+class DistanceField {
+   public:
+    static constexpr float far = 1e20f;
+
+    static std::vector<float> squared(const std::vector<std::uint8_t> &mask, int width, int height) {
+        std::vector<float> out((std::size_t)width * height, far);
+        if (width <= 0 || height <= 0) return out;
+
+        // Columns: gathered into a contiguous line so the 1D pass streams
+        parallelFor(
+            (std::size_t)width,
+            [&](std::size_t begin, std::size_t end) {
+                Line line(height);
+                for (std::size_t x = begin; x < end; x++) {
+                    for (int y = 0; y < height; y++) line.f[y] = mask[(std::size_t)y * width + x] ? 0.f : far;
+                    line.transform(height);
+                    for (int y = 0; y < height; y++) out[(std::size_t)y * width + x] = line.d[y];
+                }
+            },
+            16);
+
+        // Rows, over the column result
+        parallelFor(
+            (std::size_t)height,
+            [&](std::size_t begin, std::size_t end) {
+                Line line(width);
+                for (std::size_t y = begin; y < end; y++) {
+                    float *row = out.data() + y * width;
+                    std::copy(row, row + width, line.f.begin());
+                    line.transform(width);
+                    std::copy(line.d.begin(), line.d.begin() + width, row);
+                }
+            },
+            16);
+        return out;
+    }
+
+   private:
+    // Scratch for one 1D transform: d[q] = min over p of (q - p)^2 + f[p]. Parabola intersections
+    // are found in double: q^2 passes float's 24-bit mantissa on lines over 4096 cells, and the
+    // envelope would then keep the wrong parabolas.
+    struct Line {
+        std::vector<float> f, d;
+        std::vector<double> z;
+        std::vector<int> v;
+
+        explicit Line(int n) : f(n), d(n), z(n + 1), v(n) {}
+
+        void transform(int n) {
+            if (n == 0) return;
+            auto intersect = [&](int q, int p) {
+                return (((double)f[q] + (double)q * q) - ((double)f[p] + (double)p * p)) / (2.0 * (q - p));
+            };
+
+            // Lower envelope of the parabolas rooted at (p, f[p]); sources at `far` never join it
+            int k = -1;
+            for (int q = 0; q < n; q++) {
+                if (f[q] >= far) continue;
+                double s = -far;
+                while (k >= 0 && (s = intersect(q, v[k])) <= z[k]) k--;
+                if (k < 0) s = -far;
+                v[++k] = q;
+                z[k] = s;
+            }
+            if (k < 0) {
+                std::fill(d.begin(), d.begin() + n, far);
+                return;
+            }
+            z[k + 1] = far;
+
+            for (int q = 0, j = 0; q < n; q++) {
+                while (z[j + 1] < (double)q) j++;
+                double dq = (double)(q - v[j]);
+                d[q] = (float)(dq * dq + f[v[j]]);
+            }
+        }
+    };
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,179 @@
+#ifndef FARM_GRID_HPP_
+#define FARM_GRID_HPP_
+
+#include "distanceField.hpp"
+#include "land.hpp"
+
+namespace Harvestor {
+// ---------------- CellSpan ----------------
+// Cells x0 .. x1 - 1 of grid row y (see Region::spans)
+struct CellSpan {
+    int y, x0, x1;
+};
+
+// ---------------- FarmGrid ----------------
+// The farm as a dense 2D grid in cell coordinates (the integer x,y of input/land.csv and
+// input/water.csv): a land mask saying which tile covers each cell, a water mask of pond cells and
+// per-cell attribute rasters, all row-major. Neighbours are an index step away, rectangles are row
+// slices, and world positions (cell * cellSize) are only needed to draw. Built from the lands and
+// ponds whenever the layout changes; immutable in between. The grid spans the land plus a margin of
+// Land::pondReach cells: pond cells further out cannot water any tile and are left out.
+class FarmGrid {
+   public:
+    float cellSize = Config::landTileSize;  // world units per cell
+    sf::Vector2i origin;                    // cell coordinates of grid index 0
+    int width = 0, height = 0;
+
+    std::vector<std::int16_t> landMask;   // land index covering the cell, -1 outside every land
+    std::vector<std::int32_t> tileIndex;  // index into lands[landMask].tiles, -1 outside
+    std::vector<std::uint8_t> waterMask;  // 1 where a pond tile sits
+    std::vector<float> staticQuality;     // static soil quality (no water term), 0 outside
+    std::vector<float> compaction;        // soil compaction, 0 outside
+    std::vector<float> pondDistance;      // cells to the nearest pond cell (DistanceField::far without ponds)
+    std::vector<float> pondCoverage;      // Land's water model: 1 - pondDistance / Land::pondReach, floored at 0
+    std::size_t landCells = 0;
+    std::size_t duplicates = 0;  // tiles sharing a cell with an earlier tile; only the first is in the mask
+
+    FarmGrid() = default;
+    FarmGrid(const std::vector<Land> &lands, const std::vector<Pond> &ponds) { build(lands, ponds); }
+
+    std::size_t cells() const { return (std::size_t)width * height; }
+
+    // One cell across all layers
+    static constexpr std::size_t bytesPerCell() { return sizeof(std::int16_t) + sizeof(std::int32_t) + sizeof(std::uint8_t) + 4 * sizeof(float); }
+
+    void reportMemory(MemoryReport &report) const {
+        report.add(Caches, "farm grid", MemoryReport::vectorBytes(landMask) + MemoryReport::vectorBytes(tileIndex) + MemoryReport::vectorBytes(waterMask) +
+                                            MemoryReport::vectorBytes(staticQuality) + MemoryReport::vectorBytes(compaction) +
+                                            MemoryReport::vectorBytes(pondDistance) + MemoryReport::vectorBytes(pondCoverage));
+    }
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    int index(int x, int y) const { return y * width + x; }
+    bool isLand(int i) const { return landMask[i] >= 0; }
+
+    // Grid (not input) coordinates of a tile or pond tile position, and back (top-left corner of the cell)
+    sf::Vector2i gridOf(const sf::Vector2f &world) const { return ChunkIndex::cellOf(world, cellSize) - origin; }
+    // Grid coordinates of the cell containing an arbitrary world point (may be outside the grid)
+    sf::Vector2i cellAt(const sf::Vector2f &world) const {
+        return sf::Vector2i((int)std::floor(world.x / cellSize) - origin.x, (int)std::floor(world.y / cellSize) - origin.y);
+    }
+    sf::Vector2f worldOf(int x, int y) const { return sf::Vector2f((origin.x + x) * cellSize, (origin.y + y) * cellSize); }
+
+    // Grid cells a world-space rectangle overlaps, clipped to the grid (empty if none)
+    sf::IntRect cellsIn(const sf::FloatRect &world) const {
+        if (width == 0 || world.width <= 0.f || world.height <= 0.f) return {};
+        int x0 = std::max(0, (int)std::floor(world.left / cellSize) - origin.x);
+        int y0 = std::max(0, (int)std::floor(world.top / cellSize) - origin.y);
+        int x1 = std::min(width, (int)std::ceil((world.left + world.width) / cellSize) - origin.x);
+        int y1 = std::min(height, (int)std::ceil((world.top + world.height) / cellSize) - origin.y);
+        if (x1 <= x0 || y1 <= y0) return {};
+        return sf::IntRect(x0, y0, x1 - x0, y1 - y0);
+    }
+
+    // fn(land, tile) for every land cell in `rect` (grid coordinates), row by row
+    template <typename Fn>
+    void forEachTile(const sf::IntRect &rect, Fn &&fn) const {
+        for (int y = rect.top; y < rect.top + rect.height; y++) {
+            int row = index(rect.left, y);
+            for (int i = row; i < row + rect.width; i++) {
+                if (landMask[i] >= 0) fn((int)landMask[i], (int)tileIndex[i]);
+            }
+        }
+    }
+
+    // fn(land, tile) for every land cell of `spans`, in order
+    template <typename Fn>
+    void forEachTile(const std::vector<CellSpan> &spans, Fn &&fn) const {
+        for (const auto &span : spans) {
+            int row = index(0, span.y);
+            for (int i = row + span.x0; i < row + span.x1; i++) {
+                if (landMask[i] >= 0) fn((int)landMask[i], (int)tileIndex[i]);
+            }
+        }
+    }
+
+    void build(const std::vector<Land> &lands, const std::vector<Pond> &ponds) {
+        *this = FarmGrid();
+        if (!lands.empty()) cellSize = lands[0].tileSize;
+
+        // Land bounds plus the pond margin
+        sf::Vector2i lo(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        sf::Vector2i hi(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
+        for (const auto &land : lands) {
+            for (const auto &tile : land.tiles) {
+                sf::Vector2i c = ChunkIndex::cellOf(tile.position, cellSize);
+                lo = {std::min(lo.x, c.x), std::min(lo.y, c.y)};
+                hi = {std::max(hi.x, c.x), std::max(hi.y, c.y)};
+            }
+        }
+        if (lo.x > hi.x) return;
+        int margin = (int)std::ceil(Land::pondReach);
+
+        origin = lo - sf::Vector2i(margin, margin);
+        width = hi.x - lo.x + 1 + 2 * margin;
+        height = hi.y - lo.y + 1 + 2 * margin;
+        landMask.assign(cells(), -1);
+        tileIndex.assign(cells(), -1);
+        waterMask.assign(cells(), 0);
+        staticQuality.assign(cells(), 0.f);
+        compaction.assign(cells(), 0.f);
+
+        std::vector<float> quality;
+        for (int l = 0; l < (int)lands.size(); l++) {
+            const Land &land = lands[l];
+            quality.resize(land.tiles.size());
+            land.soil.staticQuality(0, land.tiles.size(), quality.data());
+            for (int t = 0; t < (int)land.tiles.size(); t++) {
+                sf::Vector2i c = gridOf(land.tiles[t].position);
+                int i = index(c.x, c.y);
+                if (landMask[i] >= 0) {
+                    duplicates++;
+                    continue;
+                }
+                landMask[i] = (std::int16_t)l;
+                tileIndex[i] = t;
+                staticQuality[i] = quality[t];
+                compaction[i] = land.soil.get(t, Compaction);
+                landCells++;
+            }
+        }
+        for (const auto &pond : ponds) {
+            for (const auto &ptile : pond.tiles) {
+                sf::Vector2i c = gridOf(ptile.position);
+                if (inside(c.x, c.y)) waterMask[index(c.x, c.y)] = 1;
+            }
+        }
+        computePondDistance();
+    }
+
+    // Distance transform of the water mask; pond tiles are one cell, so distances in cells times
+    // cellSize are the centre-to-centre distances Land's water model uses
+    void computePondDistance() {
+        pondDistance = DistanceField::squared(waterMask, width, height);
+        pondCoverage.resize(pondDistance.size());
+        for (std::size_t i = 0; i < pondDistance.size(); i++) {
+            pondDistance[i] = std::sqrt(pondDistance[i]);
+            pondCoverage[i] = std::max(0.f, 1.f - pondDistance[i] / Land::pondReach);
+        }
+    }
+
+    // Copies pondCoverage onto every tile (Land::pondCoverage), duplicates included
+    void applyPondCoverage(std::vector<Land> &lands) const {
+        for (auto &land : lands) {
+            land.pondCoverage.resize(land.tiles.size());
+            for (std::size_t t = 0; t < land.tiles.size(); t++) {
+                sf::Vector2i c = gridOf(land.tiles[t].position);
+                land.pondCoverage[t] = inside(c.x, c.y) ? pondCoverage[index(c.x, c.y)] : 0.f;
+            }
+        }
+    }
+
+    std::size_t bytes() const {
+        return landMask.size() * sizeof(std::int16_t) + tileIndex.size() * sizeof(std::int32_t) + waterMask.size() +
+               (staticQuality.size() + compaction.size() + pondDistance.size() + pondCoverage.size()) * sizeof(float);
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
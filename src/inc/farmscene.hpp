@@ -5,27 +5,39 @@
 
 #include <nlohmann/json.hpp>
 
+#include "camera.hpp"
 #include "common.hpp"
+#include "cropPlanner.hpp"
 #include "evaluator.hpp"
 #include "grassManager.hpp"
+#include "irrigation.hpp"
 #include "loader.hpp"
+#include "simThread.hpp"
+#include "startup.hpp"
 namespace Harvestor {
 // ---------------- FarmScene ----------------
 class FarmScene {
     sf::RenderWindow &window;
     GrassManager &grassManager;
     float width, height;
+    Camera camera;
     sf::Font font;
-    sf::Clock simClock;
     Evaluator evaluator;
 
    public:
-    // World data
+    // World data; tile state is owned by the simulation thread while it runs. Tile storage lives in
+    // `arena`, declared first so it outlives lands and ponds
+    LayoutArena arena;
     std::vector<Land> lands;
     std::vector<Pond> ponds;
-
-    // Crops
-    std::vector<CropType> cropTypes;
+    SimThread sim{lands, ponds};
+    std::uint64_t submitTicket = 0;   // pending WriteOutput; evaluator reloads once it is applied
+    std::uint64_t restoreTicket = 0;  // pending RestoreCheckpoint; UI flags follow once it is applied
+    bool weatherEnabled = false;      // LoadWeather posted
+    bool diffusionEnabled = Config::moistureDiffusion;  // SetDiffusion posted
+
+    // Crops (types live in CropRegistry; the dropdown index is the CropId)
+    CropRegistry &crops = CropRegistry::get();
     int selectedCropIndex = -1;
     bool cropDropdownActive = false;
     int cropScrollOffset = 0;
@@ -33,19 +45,21 @@ class FarmScene {
 
     // Layouts (new)
     std::vector<std::string> layouts;  // filenames (just name.ext)
+    std::future<std::vector<std::string>> layoutScan;  // pending loadAvailableLayouts, collected by update()
     int selectedLayoutIndex = -1;      // currently chosen layout (index in layouts), -1 = none
     bool layoutDropdownActive = false;
     int layoutScrollOffset = 0;
 
     // Simulation controls
     bool simulate = false;
-    bool alreadySelectionInProgress = false;
     bool selectAreaActive = false;
 
     // Rain
     bool rainActive = false;
     bool analysisRequested = false;
     sf::Clock rainClock;
+    std::uint64_t rainShowers = 0;  // keys drop placement, one step per shower
+    std::uint64_t rainFrames = 0;   // keys drop respawns
     std::vector<RainDrop> raindrops;
     std::vector<Splash> splashes;
     std::vector<Ripple> ripples;
@@ -53,43 +67,96 @@ class FarmScene {
     // selection area
     enum class SelectionState { None, Clicked, Selecting, Selected, Done };
     SelectionState selectionState = SelectionState::None;
+    Region::Shape selectionShape = Region::Rect;  // L cycles rectangle, circle and lasso
     sf::Vector2f selectionStart;
     sf::Vector2f selectionEnd;
-    sf::RectangleShape selectionRect;
+    Region selection;                     // world space
+    std::vector<CellSpan> selectionSpans;  // selection on sim.grid(), refreshed while dragging
     bool showAnalysisPopup = false;
     int selectedTilesCount = 0;
 
-    FarmScene(sf::RenderWindow &win, GrassManager &gm, float w, float h) : window(win), grassManager(gm), width(w), height(h) {
-        if (!font.loadFromFile(Config::fontPath)) std::cerr << "Failed to load font from: " << Config::fontPath << "\n";
-
-        cropTypes = CropLoader::loadFromFile(Config::cropsFile);
-
-        // Load available layouts safely
+    // Cached UI panel / HUD renders and the inputs they were built from
+    struct UiState {
+        int selectedCrop = -1, cropScroll = 0, selectedLayout = -1, layoutScroll = 0, cropCount = 0, layoutCount = 0;
+        bool cropOpen = false, layoutOpen = false, simulate = false, raining = false, selecting = false, analysis = false;
+        bool operator==(const UiState &o) const {
+            return std::tie(selectedCrop, cropScroll, selectedLayout, layoutScroll, cropCount, layoutCount, cropOpen, layoutOpen, simulate, raining,
+                            selecting, analysis) == std::tie(o.selectedCrop, o.cropScroll, o.selectedLayout, o.layoutScroll, o.cropCount,
+                                                             o.layoutCount, o.cropOpen, o.layoutOpen, o.simulate, o.raining, o.selecting, o.analysis);
+        }
+    };
+    struct HudState {
+        int seconds = 0;
+        bool raining = false;
+        int soilPct = 0, waterPct = 0, growthPct = 0;
+        int weatherHour = -1, temperature = 0;  // weatherHour -1: no weather series
+        int overlay = -1;                       // HeatmapOverlay::mode
+        int memoryMB = 0, bytesPerTile = 0;     // MemoryReport of the scene
+        bool operator==(const HudState &o) const {
+            return std::tie(seconds, raining, soilPct, waterPct, growthPct, weatherHour, temperature, overlay, memoryMB, bytesPerTile) ==
+                   std::tie(o.seconds, o.raining, o.soilPct, o.waterPct, o.growthPct, o.weatherHour, o.temperature, o.overlay, o.memoryMB,
+                            o.bytesPerTile);
+        }
+    };
+    sf::RenderTexture uiTexture, hudTexture;
+    UiState uiState;
+    HudState hudState;
+    bool uiDirty = true, hudDirty = true;
+    HeatmapOverlay overlay;
+    sf::Clock overlayClock;  // drives the overlay pulse
+    MemoryReport memory;     // refreshed once a second for the HUD
+    sf::Clock memoryClock;
+
+    FarmScene(sf::RenderWindow &win, GrassManager &gm, float w, float h) : window(win), grassManager(gm), width(w), height(h), camera(w, h) {
+        StartupProfile &startup = StartupProfile::get();
+        startup.mark("scene members");
+        ResourceCache::get().loadFont(font, Config::fontPath);
+        startup.mark("font");
+
+        crops.loadFromFile(Config::cropsFile);
+        startup.mark("crop registry");
+
+        // Load available layouts safely, off the startup path: the dropdown fills in when the scan is done
         loadAvailableLayouts("layouts");
+        startup.mark("layout scan started");
+
+        sim.start();
+        startup.mark("simulation thread");
     }
-    // Scan a folder for .txt layout files
+    // Scan a folder for .txt layout files, in the background; update() picks up the result
     void loadAvailableLayouts(const std::string &folder) {
         layouts.clear();
+        layoutScan = std::async(std::launch::async, [folder]() {
+            std::vector<std::string> found = scanLayouts(folder);
+            StartupProfile::get().milestone("layout scan (" + std::to_string(found.size()) + ")");
+            return found;
+        });
+    }
 
+    static std::vector<std::string> scanLayouts(const std::string &folder) {
+        std::vector<std::string> found;
         std::filesystem::path layoutsPath(folder);
 
-        if (!std::filesystem::exists(layoutsPath) || !std::filesystem::is_directory(layoutsPath)) {
+        std::error_code error;
+        if (!std::filesystem::is_directory(layoutsPath, error)) {
             std::cerr << "Layout folder does not exist: " << folder << "\n";
-            return;
+            return found;
         }
 
-        for (const auto &entry : std::filesystem::directory_iterator(layoutsPath)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".txt") {
-                layouts.push_back(removeExtension(entry.path().filename().string()));  // just filename
-                std::cout << "Found layout: " << entry.path().filename().string() << "\n";
+        for (const auto &entry : std::filesystem::directory_iterator(layoutsPath, error)) {
+            if (entry.is_regular_file(error) && entry.path().extension() == ".txt") {
+                found.push_back(removeExtension(entry.path().filename().string()));  // just filename
             }
         }
 
-        std::sort(layouts.begin(), layouts.end());
+        std::sort(found.begin(), found.end());
 
-        if (layouts.empty()) std::cerr << "No .txt layout files found in folder: " << folder << "\n";
+        if (found.empty()) std::cerr << "No .txt layout files found in folder: " << folder << "\n";
+        return found;
     }
 
+    CropId selectedCrop() const { return (selectedCropIndex >= 0 && selectedCropIndex < (int)crops.size()) ? (CropId)selectedCropIndex : kNoCrop; }
+
     std::string getLayoutFullPath(int index) const {
         if (index < 0 || index >= (int)layouts.size()) return "";
         return "layouts/" + layouts[index];
@@ -101,37 +168,83 @@ class FarmScene {
             return;
         }
 
+        sim.stop();  // the world is replaced wholesale
         lands.clear();
         ponds.clear();
-        FarmLoader::loadFromFile(filePath, lands, ponds, cropTypes, selectedCropIndex);
-        std::cout << "Loaded lands: " << lands.size() << ", ponds: " << ponds.size() << "\n";
+        arena.reset();  // the previous layout's tiles, in one go
+        FarmLoader::loadFromFile(filePath, lands, ponds, selectedCrop(), arena.resource());
+        std::cout << "Loaded lands: " << lands.size() << ", ponds: " << ponds.size() << ", " << arena.bytesUsed() / 1024 << " KiB of layout arena\n";
+        sim.start();
+
+        fitCameraToWorld();
+    }
 
-        grassManager.generate(width, height);
-        simClock.restart();
+    // World-space bounding box of all land and pond tiles
+    sf::FloatRect worldBounds() const {
+        float minX = std::numeric_limits<float>::max(), minY = minX;
+        float maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+        for (auto &land : lands) {
+            for (auto &tile : land.tiles) {
+                minX = std::min(minX, tile.position.x);
+                minY = std::min(minY, tile.position.y);
+                maxX = std::max(maxX, tile.position.x + tile.size);
+                maxY = std::max(maxY, tile.position.y + tile.size);
+            }
+        }
+        for (auto &pond : ponds) {
+            for (auto &ptile : pond.tiles) {
+                minX = std::min(minX, ptile.position.x);
+                minY = std::min(minY, ptile.position.y);
+                maxX = std::max(maxX, ptile.position.x + ptile.size);
+                maxY = std::max(maxY, ptile.position.y + ptile.size);
+            }
+        }
+        if (minX > maxX) return sf::FloatRect();
+        return sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
     }
 
+    void fitCameraToWorld() { camera.fitTo(worldBounds()); }
+
     void startRain() {
+        sim.post({SimCommand::StartRain});
         rainActive = true;
         rainClock.restart();
         raindrops.clear();
         splashes.clear();
         ripples.clear();
-        std::uniform_int_distribution<int> posXDist((int)Config::uiPanelWidth, (int)width - 1);
-        std::uniform_int_distribution<int> posYDist(0, (int)height - 1);
-        std::uniform_int_distribution<int> speedDist(200, 350);
-        static std::mt19937 rng((unsigned)time(nullptr));
+        const CounterRng rng(RngStream::RainDrops, sim.snapshot().seed);
+        rainShowers++;
         for (int i = 0; i < Config::numRaindrops; i++) {
             RainDrop rd;
-            rd.position = sf::Vector2f((float)posXDist(rng), (float)posYDist(rng));
-            rd.speed = (float)speedDist(rng);
+            rd.position = sf::Vector2f((float)rng.uniformInt((int)Config::uiPanelWidth, (int)width - 1, i, rainShowers, 0),
+                                       (float)rng.uniformInt(0, (int)height - 1, i, rainShowers, 1));
+            rd.speed = (float)rng.uniformInt(200, 350, i, rainShowers, 2);
             raindrops.push_back(rd);
         }
     }
 
-    // Called from main loop with dt
+    // Called from main loop with dt. Growth runs on the simulation thread; this picks up its
+    // latest snapshot and animates the screen-space effects.
     void update(float dt) {
-        float simTime = simClock.getElapsedTime().asSeconds();
-        for (auto &land : lands) land.updateGrowth(dt, ponds, simulate, rainActive, simTime);
+        camera.update(dt);
+        sim.acquire();
+
+        if (layoutScan.valid() && layoutScan.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            layouts = layoutScan.get();
+            layoutScrollOffset = 0;
+            std::cout << "Found " << layouts.size() << " layouts\n";
+        }
+
+        const FrameSnapshot &frame = sim.snapshot();
+        if (submitTicket > 0 && frame.applied >= submitTicket) {
+            evaluator.updateSoilData();
+            evaluator.updateCropData();
+            submitTicket = 0;
+        }
+        if (restoreTicket > 0 && frame.applied >= restoreTicket) {
+            simulate = frame.simulating;
+            restoreTicket = 0;
+        }
 
         if (rainActive) {
             float elapsed = rainClock.getElapsedTime().asSeconds();
@@ -139,51 +252,30 @@ class FarmScene {
                 rainActive = false;
                 raindrops.clear();
             } else {
-                // locally boost water/growth for tiles (keeps pond logic consistent)
-                for (auto &land : lands) {
-                    for (auto &tile : land.tiles) {
-                        if (!tile.hasCrop) continue;
-                        tile.waterLevel += dt * 0.3f;
-                        tile.waterLevel = std::clamp(tile.waterLevel, 0.f, 1.f);
-
-                        tile.crop.growth += dt * Config::rainGrowthBoost;
-                        tile.crop.growth = std::clamp(tile.crop.growth, 0.f, 1.f);
-                    }
-                }
-
                 // update raindrops animation
-                for (auto &rd : raindrops) {
+                const CounterRng rng(RngStream::RainDrops, frame.seed);
+                rainFrames++;
+                for (std::size_t i = 0; i < raindrops.size(); i++) {
+                    RainDrop &rd = raindrops[i];
                     rd.position.y += rd.speed * dt;
 
                     bool hitPond = false;
-                    for (auto &pond : ponds) {
-                        bool hit = false;
-
-                        for (auto &ptile : pond.tiles) {
-                            // Compute distance from the raindrop to the center of the pond tile
-                            float dx = rd.position.x - (ptile.getPosition().x + ptile.getSize().x / 2.f);
-                            float dy = rd.position.y - (ptile.getPosition().y + ptile.getSize().y / 2.f);
-                            float dist = std::sqrt(dx * dx + dy * dy);
-
-                            // Check if the raindrop hits the pond tile (inside tile bounds)
-                            if (dist < ptile.getSize().x / 2.f) {
-                                hit = true;
-                                Splash s;
-                                s.position = rd.position;
-                                splashes.push_back(s);
-                                Ripple r;
-                                r.position = rd.position;
-                                ripples.push_back(r);
-                                break;  // Stop checking other tiles in this pond
-                            }
-                        }
-
-                        if (hit) break;  // Stop checking other ponds if a hit is detected
+                    // Drops live in screen space, ponds in world space
+                    sf::Vector2f dropWorld = camera.toWorld(sf::Vector2i((int)rd.position.x, (int)rd.position.y));
+                    const FarmGrid &grid = sim.grid();
+                    sf::Vector2i cell = grid.cellAt(dropWorld);
+                    if (grid.inside(cell.x, cell.y) && grid.waterMask[grid.index(cell.x, cell.y)]) {  // the drop lands in a pond cell
+                        Splash s;
+                        s.position = rd.position;
+                        splashes.push_back(s);
+                        Ripple r;
+                        r.position = rd.position;
+                        ripples.push_back(r);
                     }
 
                     if (rd.position.y > height || hitPond) {
                         rd.position.y = 0.f;
-                        rd.position.x = (float)(Config::uiPanelWidth + (rand() % (int)(width - Config::uiPanelWidth)));
+                        rd.position.x = (float)rng.uniformInt((int)Config::uiPanelWidth, (int)width - 1, i, rainFrames, 3);
                     }
                 }
             }
@@ -195,15 +287,20 @@ class FarmScene {
     }
 
     void draw() {
-        // UI panel
-        sf::RectangleShape uiPanel(sf::Vector2f(Config::uiPanelWidth, height));
-        uiPanel.setFillColor(sf::Color(70, 70, 70));
-        window.draw(uiPanel);
-
-        // World
+        // World (camera view, only visible chunks)
+        window.setView(camera.getView());
+        sf::FloatRect visible = camera.visibleRect();
+        const FrameSnapshot &frame = sim.snapshot();
+        static const LandSnapshot empty;
         grassManager.draw(window);
-        for (auto &land : lands) land.draw(window, cropTypes[selectedCropIndex]);
-        for (auto &pond : ponds) pond.draw(window);
+        for (std::size_t i = 0; i < lands.size(); i++)
+            lands[i].draw(window, visible, camera.getPixelsPerUnit(), i < frame.lands.size() ? frame.lands[i] : empty);
+        if (sf::Shader *shader = overlay.begin(overlayClock.getElapsedTime().asSeconds())) {
+            for (std::size_t i = 0; i < lands.size() && i < frame.lands.size(); i++) lands[i].drawOverlay(window, visible, frame.lands[i], overlay, *shader);
+        }
+        for (auto &pond : ponds) pond.draw(window, visible);
+        drawSelection();
+        window.setView(window.getDefaultView());
 
         // Rain visuals
         if (rainActive) {
@@ -220,7 +317,7 @@ class FarmScene {
         // UI + info
         drawUI();
         drawSimulationInfo();
-        drawSelection();
+        drawAnalysisPopup();
     }
 
     void centerTextInButton(sf::Text &text, const sf::RectangleShape &button) {
@@ -229,30 +326,98 @@ class FarmScene {
         text.setPosition(button.getPosition().x + button.getSize().x / 2.f, button.getPosition().y + button.getSize().y / 2.f);
     }
 
+    // ---------------- HUD (cached) ----------------
+    // Farm Status box is rendered into hudTexture and only re-rendered when what it shows changes.
+    static constexpr float hudWidth = 300.f;
+    static constexpr float hudPadding = 16.f;
+    static constexpr float hudMargin = 2.f;  // room for the outline inside the texture
+
+    static float hudBoxHeight() {
+        float barHeight = 16.f, lineSpacing = 8.f, textHeight = 18.f, titleHeight = 28.f;
+        int elements = 1 + 3 + 3;  // 1 title, 3 text lines, 3 bars
+        return titleHeight + elements * (barHeight + textHeight + lineSpacing) + 3 * lineSpacing;
+    }
+
+    HudState currentHudState() const {
+        const LandStats &stats = farmStats();
+        float avgSoil = stats.avgSoil(), avgWater = stats.avgWater(), avgGrowth = stats.avgGrowth();
+        HudState state;
+        state.seconds = simulate ? (int)sim.snapshot().simTime : 0;
+        state.raining = rainActive || (sim.snapshot().weatherActive && sim.snapshot().raining);
+        if (sim.snapshot().weatherActive) {
+            state.weatherHour = (int)sim.snapshot().weather.hour;
+            state.temperature = (int)std::lround(sim.snapshot().weather.temperature);
+        }
+        state.soilPct = (int)(std::clamp(avgSoil, 0.f, 1.f) * 100);
+        state.waterPct = (int)(std::clamp(avgWater, 0.f, 1.f) * 100);
+        state.growthPct = (int)(std::clamp(avgGrowth, 0.f, 1.f) * 100);
+        state.overlay = overlay.mode;
+        state.memoryMB = (int)(memory.total() >> 20);
+        state.bytesPerTile = (int)std::lround(memory.bytesPerTile());
+        return state;
+    }
+
+    // Everything the scene holds, per subsystem (HUD); render thread
+    MemoryReport memoryReport() const {
+        MemoryReport report;
+        sim.reportMemory(report);
+        arena.reportMemory(report);
+        evaluator.reportMemory(report);
+        ResourceCache::get().reportMemory(report);
+        report.add(ParticlePools, "raindrops", MemoryReport::vectorBytes(raindrops));
+        report.add(ParticlePools, "splashes", MemoryReport::vectorBytes(splashes));
+        report.add(ParticlePools, "ripples", MemoryReport::vectorBytes(ripples));
+        auto targetBytes = [](const sf::RenderTexture &t) { return (std::size_t)t.getSize().x * t.getSize().y * 4; };
+        report.add(RenderBuffers, "UI panel and HUD (GPU)", targetBytes(uiTexture) + targetBytes(hudTexture));
+        return report;
+    }
+
+    // Farm-wide aggregates from the latest snapshot (sum of each land's running stats)
+    const LandStats &farmStats() const { return sim.snapshot().stats; }
+
     void drawSimulationInfo() {
-        // HUD positioning
-        float padding = 16.f;
+        if (memory.items.empty() || memoryClock.getElapsedTime().asSeconds() >= 1.f) {
+            memory = memoryReport();
+            memoryClock.restart();
+        }
+        HudState state = currentHudState();
+        if (hudDirty || !(state == hudState)) {
+            hudState = state;
+            renderHud();
+            hudDirty = false;
+        }
+
+        sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
+        float screenW = (float)desktop.width;
+        sf::Sprite hud(hudTexture.getTexture());
+        hud.setPosition(screenW - hudWidth - hudPadding - hudMargin, hudPadding - hudMargin);  // top-right
+        window.draw(hud);
+    }
+
+    void renderHud() {
+        // HUD positioning (texture-local)
+        float padding = hudPadding;
         float barHeight = 16.f;
         float radius = barHeight / 2.f;  // rounded ends
         float lineSpacing = 8.f;         // space between lines
         float textHeight = 18.f;         // approximate text height
         float titleHeight = 28.f;
 
-        sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
-        float screenW = (float)desktop.width;
-        float hudWidth = 300.f;
-        float hudX = screenW - hudWidth - padding;  // top-right with 6.f gap
-        float hudY = padding;
+        float hudX = hudMargin;
+        float hudY = hudMargin;
+        float boxHeight = hudBoxHeight();
+
+        unsigned texW = (unsigned)(hudWidth + 2 * hudMargin), texH = (unsigned)(boxHeight + 2 * hudMargin);
+        if (hudTexture.getSize().x != texW || hudTexture.getSize().y != texH) hudTexture.create(texW, texH);
+        sf::RenderTexture &target = hudTexture;
+        target.clear(sf::Color::Transparent);
 
-        // Count elements: title + time + rain + 3 bars
-        int elements = 1 + 2 + 3;  // 1 title, 2 text lines, 3 bars
-        float boxHeight = titleHeight + elements * (barHeight + textHeight + lineSpacing) + 3 * lineSpacing;
         sf::RectangleShape bgBox(sf::Vector2f(hudWidth, boxHeight));
         bgBox.setPosition(hudX, hudY);
         bgBox.setFillColor(sf::Color(40, 40, 40, 200));
         bgBox.setOutlineColor(sf::Color::White);
         bgBox.setOutlineThickness(2.f);
-        window.draw(bgBox);
+        target.draw(bgBox);
 
         float currentY = hudY + padding;
 
@@ -260,44 +425,39 @@ class FarmScene {
         sf::Text title("Farm Status", font, 20);
         title.setPosition(hudX + padding, currentY);
         title.setFillColor(sf::Color(255, 215, 0));
-        window.draw(title);
+        target.draw(title);
 
         currentY += titleHeight + lineSpacing;
 
         // Time
-        float elapsed = simulate ? simClock.getElapsedTime().asSeconds() : 0.f;
-        sf::Text timeText("Time: " + std::to_string(int(elapsed)) + "s", font, 16);
+        std::string timeLabel = "Time: " + std::to_string(hudState.seconds) + "s";
+        if (hudState.weatherHour >= 0)
+            timeLabel += "  Day " + std::to_string(hudState.weatherHour / 24 + 1) + " " + std::to_string(hudState.weatherHour % 24) + ":00 " +
+                         std::to_string(hudState.temperature) + "C";
+        sf::Text timeText(timeLabel, font, 16);
         timeText.setPosition(hudX + padding, currentY);
         timeText.setFillColor(sf::Color::Cyan);
-        window.draw(timeText);
+        target.draw(timeText);
 
         currentY += textHeight + lineSpacing;
 
         // Raining info
-        sf::Text rainText("Raining: " + std::string(rainActive ? "Yes" : "No"), font, 16);
+        std::string rainLabel = "Raining: " + std::string(hudState.raining ? "Yes" : "No");
+        if (hudState.overlay >= 0) rainLabel += "  Overlay: " + std::string(HeatmapOverlay::modes()[hudState.overlay].name);
+        sf::Text rainText(rainLabel, font, 16);
         rainText.setPosition(hudX + padding, currentY);
-        rainText.setFillColor(rainActive ? sf::Color::Blue : sf::Color(180, 180, 180));
-        window.draw(rainText);
+        rainText.setFillColor(hudState.raining ? sf::Color::Blue : sf::Color(180, 180, 180));
+        target.draw(rainText);
 
-        currentY += textHeight + 2 * lineSpacing;  // extra spacing before bars
+        currentY += textHeight + lineSpacing;
 
-        // Compute averages
-        float avgSoil = 0.f, avgWater = 0.f, avgGrowth = 0.f;
-        int cropTiles = 0, totalTiles = 0;
-        for (auto &land : lands) {
-            totalTiles += (int)land.tiles.size();
-            for (auto &tile : land.tiles) {
-                avgSoil += land.computeSoilQuality(tile, tile.cropType);
-                avgWater += tile.waterLevel;
-                if (tile.hasCrop) {
-                    avgGrowth += tile.crop.growth;
-                    cropTiles++;
-                }
-            }
-        }
-        if (totalTiles > 0) avgSoil /= totalTiles;
-        if (totalTiles > 0) avgWater /= totalTiles;
-        if (cropTiles > 0) avgGrowth /= cropTiles;
+        // Memory
+        sf::Text memoryText("Memory: " + std::to_string(hudState.memoryMB) + " MB, " + std::to_string(hudState.bytesPerTile) + " B/tile", font, 16);
+        memoryText.setPosition(hudX + padding, currentY);
+        memoryText.setFillColor(sf::Color(180, 180, 180));
+        target.draw(memoryText);
+
+        currentY += textHeight + 2 * lineSpacing;  // extra spacing before bars
 
         auto drawRoundedBar = [&](float y, const std::string &label, float pct, sf::Color fgColor) {
             pct = std::clamp(pct, 0.f, 1.f);
@@ -305,7 +465,7 @@ class FarmScene {
             sf::Text txt(label, font, 16);
             txt.setPosition(hudX + padding, y);
             txt.setFillColor(sf::Color::White);
-            window.draw(txt);
+            target.draw(txt);
 
             float barWidth = hudWidth - 2 * padding;
 
@@ -313,55 +473,59 @@ class FarmScene {
             sf::RectangleShape bg(sf::Vector2f(barWidth, barHeight));
             bg.setPosition(hudX + padding, y + textHeight);
             bg.setFillColor(sf::Color(80, 80, 80));
-            window.draw(bg);
+            target.draw(bg);
 
             // Foreground bar
             sf::RectangleShape fg(sf::Vector2f(barWidth * pct, barHeight));
             fg.setPosition(hudX + padding, y + textHeight);
             fg.setFillColor(fgColor);
-            window.draw(fg);
+            target.draw(fg);
 
             // Rounded ends using circles
             sf::CircleShape leftCap(radius);
             leftCap.setFillColor(fgColor);
             leftCap.setPosition(hudX + padding - radius, y + textHeight - radius + barHeight / 2.f);
-            window.draw(leftCap);
+            target.draw(leftCap);
 
             sf::CircleShape rightCap(radius);
             rightCap.setFillColor(fgColor);
             rightCap.setPosition(hudX + padding + barWidth * pct - radius, y + textHeight - radius + barHeight / 2.f);
-            window.draw(rightCap);
+            target.draw(rightCap);
 
             // Percentage text
             sf::Text pctText(std::to_string(int(pct * 100)) + "%", font, 14);
 
             pctText.setPosition(hudX + hudWidth - padding - 40, y + textHeight);
             pctText.setFillColor(sf::Color::White);
-            window.draw(pctText);
+            target.draw(pctText);
         };
 
-        drawRoundedBar(currentY, "Avg Soil", avgSoil, sf::Color::Green);
+        drawRoundedBar(currentY, "Avg Soil", hudState.soilPct / 100.f, sf::Color::Green);
         currentY += barHeight + textHeight + 2 * lineSpacing;
 
-        drawRoundedBar(currentY, "Water Level", avgWater, sf::Color::Blue);
+        drawRoundedBar(currentY, "Water Level", hudState.waterPct / 100.f, sf::Color::Blue);
         currentY += barHeight + textHeight + 2 * lineSpacing;
 
-        drawRoundedBar(currentY, "Crop Growth", avgGrowth, sf::Color(255, 165, 0));
+        drawRoundedBar(currentY, "Crop Growth", hudState.growthPct / 100.f, sf::Color(255, 165, 0));
+        target.display();
     }
 
     // New: handle mouse wheel scroll (call from main loop)
-    void handleMouseWheelScroll(float delta) {
+    void handleMouseWheelScroll(float delta, sf::Vector2i mousePos) {
         if (cropDropdownActive) {
             if (delta > 0 && cropScrollOffset > 0) cropScrollOffset--;
-            if (delta < 0 && cropScrollOffset + Config::maxVisibleCrops < (int)cropTypes.size()) cropScrollOffset++;
+            if (delta < 0 && cropScrollOffset + Config::maxVisibleCrops < (int)crops.size()) cropScrollOffset++;
         }
         if (layoutDropdownActive) {
             if (delta > 0 && layoutScrollOffset > 0) layoutScrollOffset--;
             if (delta < 0 && layoutScrollOffset + Config::maxVisibleCrops < (int)layouts.size()) layoutScrollOffset++;
         }
+        if (!cropDropdownActive && !layoutDropdownActive && camera.isInViewport(mousePos)) {
+            camera.zoomAt(mousePos, std::pow(Config::cameraZoomStep, delta));
+        }
     }
 
-    std::string removeExtension(const std::string &filename) {
+    static std::string removeExtension(const std::string &filename) {
         size_t dotPos = filename.find_last_of('.');
         if (dotPos != std::string::npos) {
             return filename.substr(0, dotPos);
@@ -370,7 +534,7 @@ class FarmScene {
     }
 
     // Generic dropdown drawer
-    void drawDropdown(float x, float &y, const std::string &mainLabel, const std::vector<std::string> &items, int selectedIndex, bool &active,
+    void drawDropdown(sf::RenderTarget &target, float x, float &y, const std::string &mainLabel, const std::vector<std::string> &items, int selectedIndex, bool &active,
                       int scrollOffset, int maxVisible) {
         float btnHeight = Config::cropButtonHeight;
 
@@ -378,12 +542,12 @@ class FarmScene {
         sf::RectangleShape mainBtn(sf::Vector2f(Config::cropButtonWidth, btnHeight));
         mainBtn.setPosition(x, y);
         mainBtn.setFillColor(sf::Color(180, 180, 250));
-        window.draw(mainBtn);
+        target.draw(mainBtn);
 
         sf::Text mainTxt(mainLabel, font, 16);
         mainTxt.setPosition(x + 5, y + 5);
         mainTxt.setFillColor(sf::Color::Black);
-        window.draw(mainTxt);
+        target.draw(mainTxt);
 
         // --- Dropdown arrow (triangle) ---
         sf::ConvexShape arrow;
@@ -404,7 +568,7 @@ class FarmScene {
             arrow.setPoint(2, sf::Vector2f(arrowX, arrowY + arrowSize / 2));
         }
         arrow.setFillColor(sf::Color::Black);
-        window.draw(arrow);
+        target.draw(arrow);
 
         y += btnHeight;  // Move y down for items or next button
 
@@ -418,12 +582,12 @@ class FarmScene {
                 sf::RectangleShape itemBtn(sf::Vector2f(Config::cropButtonWidth, btnHeight));
                 itemBtn.setPosition(x, y + i * btnHeight);
                 itemBtn.setFillColor(idx == selectedIndex ? Config::cropButtonSelectedColor : Config::cropButtonColor);
-                window.draw(itemBtn);
+                target.draw(itemBtn);
 
                 sf::Text itemTxt(items[idx], font, 16);
                 itemTxt.setPosition(x + 5, y + 5 + i * btnHeight);
                 itemTxt.setFillColor(sf::Color::Black);
-                window.draw(itemTxt);
+                target.draw(itemTxt);
             }
 
             // --- Scroll arrows ---
@@ -431,13 +595,13 @@ class FarmScene {
                 sf::Text upTxt("▲", font, 14);
                 upTxt.setPosition(x + Config::cropButtonWidth + 5, y);
                 upTxt.setFillColor(sf::Color::Black);
-                window.draw(upTxt);
+                target.draw(upTxt);
             }
             if (scrollOffset + visibleCount < items.size()) {
                 sf::Text downTxt("▼", font, 14);
                 downTxt.setPosition(x + Config::cropButtonWidth + 5, y + visibleCount * btnHeight);
                 downTxt.setFillColor(sf::Color::Black);
-                window.draw(downTxt);
+                target.draw(downTxt);
             }
 
             y += visibleCount * btnHeight;  // Move y after dropdown
@@ -451,7 +615,7 @@ class FarmScene {
     }
 
     // Generic button drawer
-    void drawButton(float x, float &y, const std::string &label, sf::Color baseColor, sf::Font &font, float width = -1, float height = -1,
+    void drawButton(sf::RenderTarget &target, float x, float &y, const std::string &label, sf::Color baseColor, sf::Font &font, float width = -1, float height = -1,
                     bool hovered = false, bool pressed = false) {
         if (width < 0) width = Config::cropButtonWidth;
         if (height < 0) height = Config::cropButtonHeight * Config::bigButtonHeightMultiplier;
@@ -473,7 +637,7 @@ class FarmScene {
         center.setFillColor(color);
         center.setOutlineColor(borderColor);
         center.setOutlineThickness(borderThickness);
-        window.draw(center);
+        target.draw(center);
 
         // Top/Bottom
         sf::RectangleShape top(sf::Vector2f(width - 2 * radius, radius));
@@ -481,14 +645,14 @@ class FarmScene {
         top.setFillColor(color);
         top.setOutlineColor(borderColor);
         top.setOutlineThickness(borderThickness);
-        window.draw(top);
+        target.draw(top);
 
         sf::RectangleShape bottom(sf::Vector2f(width - 2 * radius, radius));
         bottom.setPosition(x + radius, y + height - radius);
         bottom.setFillColor(color);
         bottom.setOutlineColor(borderColor);
         bottom.setOutlineThickness(borderThickness);
-        window.draw(bottom);
+        target.draw(bottom);
 
         // Left/Right
         sf::RectangleShape left(sf::Vector2f(radius, height - 2 * radius));
@@ -496,14 +660,14 @@ class FarmScene {
         left.setFillColor(color);
         left.setOutlineColor(borderColor);
         left.setOutlineThickness(borderThickness);
-        window.draw(left);
+        target.draw(left);
 
         sf::RectangleShape right(sf::Vector2f(radius, height - 2 * radius));
         right.setPosition(x + width - radius, y + radius);
         right.setFillColor(color);
         right.setOutlineColor(borderColor);
         right.setOutlineThickness(borderThickness);
-        window.draw(right);
+        target.draw(right);
 
         // ---- Draw corners with border ----
         sf::CircleShape corner(radius, cornerPoints);
@@ -513,51 +677,87 @@ class FarmScene {
 
         // Top-left
         corner.setPosition(x, y);
-        window.draw(corner);
+        target.draw(corner);
         // Top-right
         corner.setPosition(x + width - 2 * radius, y);
-        window.draw(corner);
+        target.draw(corner);
         // Bottom-left
         corner.setPosition(x, y + height - 2 * radius);
-        window.draw(corner);
+        target.draw(corner);
         // Bottom-right
         corner.setPosition(x + width - 2 * radius, y + height - 2 * radius);
-        window.draw(corner);
+        target.draw(corner);
 
         // ---- Draw text ----
         sf::Text txt(label, font, Config::bigButtonFontSize);
         txt.setFillColor(sf::Color::White);
         centerTextInButton(txt, sf::FloatRect(x, y, width, height));
-        window.draw(txt);
+        target.draw(txt);
 
         // Move y for next button
         y += height + Config::cropButtonSpacing + Config::ButtonInsideSpacing;
     }
 
-    // ---------------- drawUI ----------------
+    // ---------------- drawUI (cached) ----------------
+    UiState currentUiState() const {
+        UiState state;
+        state.selectedCrop = selectedCropIndex;
+        state.cropScroll = cropScrollOffset;
+        state.selectedLayout = selectedLayoutIndex;
+        state.layoutScroll = layoutScrollOffset;
+        state.cropCount = (int)crops.size();
+        state.layoutCount = (int)layouts.size();
+        state.cropOpen = cropDropdownActive;
+        state.layoutOpen = layoutDropdownActive;
+        state.simulate = simulate;
+        state.raining = rainActive;
+        state.selecting = selectAreaActive;
+        state.analysis = analysisRequested;
+        return state;
+    }
+
     void drawUI() {
+        UiState state = currentUiState();
+        if (uiDirty || !(state == uiState)) {
+            uiState = state;
+            renderUI();
+            uiDirty = false;
+        }
+        window.draw(sf::Sprite(uiTexture.getTexture()));
+    }
+
+    void renderUI() {
         sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
         float screenW = (float)desktop.width;
         float leftPanelW = screenW * 0.15f;  // 15% left side
 
+        // Slightly wider than the panel: dropdown scroll arrows sit just past the buttons
+        unsigned texW = (unsigned)(Config::uiPanelWidth + 20.f), texH = (unsigned)height;
+        if (uiTexture.getSize().x != texW || uiTexture.getSize().y != texH) uiTexture.create(texW, texH);
+        sf::RenderTexture &target = uiTexture;
+        target.clear(sf::Color::Transparent);
+
+        // UI panel
+        sf::RectangleShape uiPanel(sf::Vector2f(Config::uiPanelWidth, height));
+        uiPanel.setFillColor(sf::Color(70, 70, 70));
+        target.draw(uiPanel);
+
         float x = Config::uiPadding;
         float y = 10.f;  // top padding
 
         // Crop dropdown
-        std::vector<std::string> cropNames;
-        for (auto &c : cropTypes) cropNames.push_back(c.name);
         std::string cropLabel =
-            (selectedCropIndex >= 0 && selectedCropIndex < (int)cropTypes.size()) ? cropTypes[selectedCropIndex].name : "Select Crop";
-        drawDropdown(x, y, cropLabel, cropNames, selectedCropIndex, cropDropdownActive, cropScrollOffset, Config::maxVisibleCrops);
+            (selectedCropIndex >= 0 && selectedCropIndex < (int)crops.size()) ? crops.names[selectedCropIndex] : "Select Crop";
+        drawDropdown(target, x, y, cropLabel, crops.names, selectedCropIndex, cropDropdownActive, cropScrollOffset, Config::maxVisibleCrops);
 
         // Layout dropdown
         std::string layoutLabel =
             (selectedLayoutIndex >= 0 && selectedLayoutIndex < (int)layouts.size()) ? layouts[selectedLayoutIndex] : "Select Layout";
-        drawDropdown(x, y, layoutLabel, layouts, selectedLayoutIndex, layoutDropdownActive, layoutScrollOffset, Config::maxVisibleLayouts);
+        drawDropdown(target, x, y, layoutLabel, layouts, selectedLayoutIndex, layoutDropdownActive, layoutScrollOffset, Config::maxVisibleLayouts);
 
         // Buttons start below dropdowns
         float startY = y + Config::ButtonPadding;
-        if (cropDropdownActive) startY += (std::min(Config::maxVisibleCrops, (int)cropTypes.size()) + 1) * Config::cropButtonHeight;
+        if (cropDropdownActive) startY += (std::min(Config::maxVisibleCrops, (int)crops.size()) + 1) * Config::cropButtonHeight;
         if (layoutDropdownActive) startY += (std::min(Config::maxVisibleLayouts, (int)layouts.size()) + 1) * Config::cropButtonHeight;
 
         // Shrink both width and height by 50%
@@ -568,20 +768,23 @@ class FarmScene {
 
         sf::Color buttonBaseColor = sf::Color(50, 150, 200);
         // Draw buttons
-        drawButton(btnX, btnY, simulate ? "Simulating" : "Start", simulate ? sf::Color(0, 255, 0) : buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, simulate ? "Simulating" : "Start", simulate ? sf::Color(0, 255, 0) : buttonBaseColor, font, btnWidth, btnHeight);
 
-        drawButton(btnX, btnY, "Reset", buttonBaseColor, font, btnWidth, btnHeight);
-        drawButton(btnX, btnY, "Rain", rainActive ? sf::Color(100, 180, 255) : buttonBaseColor, font, btnWidth, btnHeight);
-        drawButton(btnX, btnY, "Submit", buttonBaseColor, font, btnWidth, btnHeight);
-        drawButton(btnX, btnY, "Load Layout", buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Reset", buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Rain", rainActive ? sf::Color(100, 180, 255) : buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Submit", buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Load Layout", buttonBaseColor, font, btnWidth, btnHeight);
 
         sf::Color selectAreaColor = selectAreaActive ? sf::Color(150, 150, 150) : buttonBaseColor;
         std::string selectText = selectAreaActive ? "Deselect" : "Select Area";
-        drawButton(btnX, btnY, selectText, selectAreaColor, font, btnWidth, btnHeight);
-
-        drawButton(btnX, btnY, "Plant Crops", buttonBaseColor, font, btnWidth, btnHeight);
-        drawButton(btnX, btnY, "Clear Results", buttonBaseColor, font, btnWidth, btnHeight);
-        drawButton(btnX, btnY, "Analyse", analysisRequested ? sf::Color(0, 255, 0) : sf::Color(buttonBaseColor), font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, selectText, selectAreaColor, font, btnWidth, btnHeight);
+
+        drawButton(target, btnX, btnY, "Plant Crops", buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Plan Crops", buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Irrigate", buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Clear Results", buttonBaseColor, font, btnWidth, btnHeight);
+        drawButton(target, btnX, btnY, "Analyse", analysisRequested ? sf::Color(0, 255, 0) : sf::Color(buttonBaseColor), font, btnWidth, btnHeight);
+        target.display();
     }
 
     // Generic dropdown click handler
@@ -655,9 +858,7 @@ class FarmScene {
         float y = 10.f;
 
         // Crop dropdown
-        std::vector<std::string> cropNames;
-        for (auto &c : cropTypes) cropNames.push_back(c.name);
-        if (handleDropdownClick(mousePos, x, y, cropNames, selectedCropIndex, cropDropdownActive, cropScrollOffset, Config::maxVisibleCrops)) return;
+        if (handleDropdownClick(mousePos, x, y, crops.names, selectedCropIndex, cropDropdownActive, cropScrollOffset, Config::maxVisibleCrops)) return;
 
         // Layout dropdown
         if (handleDropdownClick(mousePos, x, y, layouts, selectedLayoutIndex, layoutDropdownActive, layoutScrollOffset, Config::maxVisibleLayouts)) {
@@ -670,7 +871,7 @@ class FarmScene {
 
         // Buttons start below dropdowns
         float startY = y + Config::ButtonPadding;
-        if (cropDropdownActive) startY += (std::min(Config::maxVisibleCrops, (int)cropTypes.size()) + 1) * Config::cropButtonHeight;
+        if (cropDropdownActive) startY += (std::min(Config::maxVisibleCrops, (int)crops.size()) + 1) * Config::cropButtonHeight;
         if (layoutDropdownActive) startY += (std::min(Config::maxVisibleLayouts, (int)layouts.size()) + 1) * Config::cropButtonHeight;
 
         float btnWidth = (leftPanelW - 5.f * Config::uiPadding) * 0.75f;  // same as drawUI
@@ -692,16 +893,14 @@ class FarmScene {
 
         // Sequentially check each button
         if (checkButtonClick(simulate ? "Simulating" : "Start", [&]() {
-                if (!simulate) simClock.restart();
                 simulate = !simulate;
+                sim.post({SimCommand::SetSimulate, simulate});
             }))
             return;
         if (checkButtonClick("Reset", [&]() { reset(); })) return;
         if (checkButtonClick("Rain", [&]() { startRain(); })) return;
         if (checkButtonClick("Submit", [&]() {
-                writeSimulationOutput("simulation_output.csv");
-                evaluator.updateSoilData();
-                evaluator.updateCropData();
+                submitTicket = sim.post({SimCommand::WriteOutput});
             }))
             return;
         if (checkButtonClick("Load Layout", [&]() {
@@ -718,6 +917,8 @@ class FarmScene {
             }))
             return;
         if (checkButtonClick("Plant Crops", [&]() { plantCropsInSelection(); })) return;
+        if (checkButtonClick("Plan Crops", [&]() { planCrops(); })) return;
+        if (checkButtonClick("Irrigate", [&]() { optimizeIrrigation(); })) return;
         if (checkButtonClick("Clear Results", [&]() { clearSimulationResults(); })) return;
         if (checkButtonClick("Analyse", [&]() {
                 analysisRequested = !analysisRequested;
@@ -727,7 +928,7 @@ class FarmScene {
     }
 
     void plantCropsInSelection() {
-        if (selectedCropIndex < 0 || selectedCropIndex >= (int)cropTypes.size()) {
+        if (selectedCropIndex < 0 || selectedCropIndex >= (int)crops.size()) {
             std::cerr << "No crop selected for planting.\n";
             return;
         }
@@ -736,59 +937,61 @@ class FarmScene {
             return;
         }
 
-        const CropType &chosenCrop = cropTypes[selectedCropIndex];
-
-        // 1. Reset ALL crops in the farm
-        if (!alreadySelectionInProgress) {
-            for (auto &land : lands) {
-                for (auto &tile : land.tiles) {
-                    tile.hasCrop = true;
-                    tile.crop = Crop();          // reset growth
-                    tile.cropType = chosenCrop;  // store the actual crop type
-                    tile.waterLevel = chosenCrop.optimalWater;
-                    tile.soilQuality = land.computeSoilQuality(tile, chosenCrop);
-                }
-            }
-        }
-
-        // 2. Plant crops only in the selected area, using existing logic
-        sf::FloatRect selRect = selectionRect.getGlobalBounds();
-        int plantedCount = 0;
-        alreadySelectionInProgress = true;
-
-        for (auto &land : lands) {
-            for (auto &tile : land.tiles) {
-                sf::FloatRect tileRect(tile.position, sf::Vector2f(tile.size, tile.size));
-                if (selRect.intersects(tileRect)) {
-                    // Reuse your plantCrops logic on just this tile
-                    float soilFactor = tile.soilBaseQuality;
-                    tile.hasCrop = true;
-                    tile.cropType = chosenCrop;
-                    tile.crop.growth = 0.f;
-
-                    tile.crop.originalSize = sf::Vector2f(tile.size, tile.size);
+        // Planting happens on the simulation thread and touches the selected tiles only
+        SimCommand command{SimCommand::PlantArea};
+        command.crop = selectedCrop();
+        command.area = std::make_shared<const Region>(selection);
+        sim.post(command);
 
-                    sf::Vector2f initialSize = tile.crop.originalSize * Config::cropInitialScale;
-                    tile.crop.shape.setSize(initialSize);
-
-                    tile.crop.shape.setPosition(tile.position.x + (tile.size - initialSize.x) / 2, tile.position.y + (tile.size - initialSize.y) / 2);
+        clearSelection();
+    }
 
-                    tile.crop.shape.setFillColor(chosenCrop.baseColor);
+    // Plants the whole farm with the CropPlanner's assignment in one step (plot size, quotas and
+    // rotation from Config). Reads current crops for rotation, so the simulation pauses meanwhile.
+    void planCrops() {
+        if (lands.empty()) {
+            std::cerr << "No land loaded to plan crops for.\n";
+            return;
+        }
 
-                    tile.waterLevel = chosenCrop.optimalWater;
-                    tile.soilQuality = land.computeSoilQuality(tile, chosenCrop);
+        sim.stop();
+        auto start = std::chrono::steady_clock::now();
+        CropPlan plan = CropPlanner(lands, sim.grid()).plan();
+        for (std::size_t l = 0; l < lands.size(); l++) lands[l].plantMap(plan.crops[l], sim.snapshot().simTime);
+        float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        sim.start();
+
+        std::cout << "Crop plan: " << plan.plots << " fields in " << seconds << " s, mean time to mature " << plan.meanTtm << " s (unconstrained "
+                  << plan.unconstrainedMeanTtm << " s)";
+        for (std::size_t c = 0; c < plan.cropTiles.size(); c++)
+            if (plan.cropTiles[c] > 0) std::cout << ", " << crops.name((CropId)c) << " " << plan.cropTiles[c];
+        std::cout << "\n";
+        if (plan.smallPlots + plan.rotationConflicts + plan.quotaViolations > 0)
+            std::cerr << "Crop plan bends rules: " << plan.smallPlots << " small fields, " << plan.rotationConflicts << " rotation conflicts, "
+                      << plan.quotaViolations << " quotas missed\n";
+    }
 
-                    plantedCount++;
-                } else {
-                    // Outside selection, clear crop
-                    // tile.hasCrop = false;
-                }
-            }
+    // Digs Config::irrigationSources new water sources where they shorten the selected crop's
+    // time to maturity the most. Ponds are structural, so the simulation pauses meanwhile.
+    void optimizeIrrigation() {
+        if (selectedCrop() == kNoCrop) {
+            std::cerr << "No crop selected to optimize irrigation for.\n";
+            return;
+        }
+        if (lands.empty()) {
+            std::cerr << "No land loaded to irrigate.\n";
+            return;
         }
 
-        std::cout << "Reset all crops and planted " << plantedCount << " crops of type " << chosenCrop.name << " in selection.\n";
+        sim.stop();
+        auto start = std::chrono::steady_clock::now();
+        IrrigationPlan plan = IrrigationOptimizer(lands, sim.grid(), selectedCrop()).optimize(Config::irrigationSources);
+        float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+        if (!plan.sources.empty()) ponds.emplace_back(Config::landTileSize, arena.resource()).addTiles(plan.sources);
+        sim.start();
 
-        clearSelection();
+        std::cout << "Irrigation: placed " << plan.sources.size() << " water sources in " << seconds << " s, mean time to mature for "
+                  << crops.name(selectedCrop()) << " " << plan.meanTtmBefore << " s -> " << plan.meanTtmAfter << " s\n";
     }
 
     void handleSelectButtonClick() {
@@ -803,33 +1006,65 @@ class FarmScene {
     }
 
     // ---------------- Mouse handling ----------------
+    // Selection coordinates are world-space; mouse positions are window pixels.
     void handleMousePressed(sf::Vector2i mousePos) {
         // Only start the rectangle if we are waiting for the next click
-        if (selectionState == SelectionState::Clicked) {
-            selectionStart = sf::Vector2f((float)mousePos.x, (float)mousePos.y);
+        if (selectionState == SelectionState::Clicked && camera.isInViewport(mousePos)) {
+            selectionStart = camera.toWorld(mousePos);
             selectionEnd = selectionStart;
-            selectionRect.setPosition(selectionStart);
-            selectionRect.setSize(sf::Vector2f(0.f, 0.f));  // Start with zero size
-            selectionRect.setFillColor(sf::Color(0, 0, 255, 50));
-            selectionRect.setOutlineColor(sf::Color::Blue);
-            selectionRect.setOutlineThickness(2.f);
+            selection = Region();
+            selection.shape = selectionShape;
+            if (selectionShape == Region::Polygon) selection.points = {selectionStart};
+            selectionSpans.clear();
             selectionState = SelectionState::Selecting;
             std::cout << "Selection started at: " << selectionStart.x << "," << selectionStart.y << "\n";
         }
     }
 
+    void beginPan(sf::Vector2i mousePos) {
+        if (camera.isInViewport(mousePos)) camera.beginDrag(mousePos);
+    }
+
     void handleMouseMoved(sf::Vector2i mousePos) {
+        camera.drag(mousePos);
         if (selectionState == SelectionState::Selecting) {
-            selectionEnd = sf::Vector2f((float)mousePos.x, (float)mousePos.y);
-            sf::Vector2f size = selectionEnd - selectionStart;
-            selectionRect.setSize(sf::Vector2f(std::abs(size.x), std::abs(size.y)));
-            selectionRect.setPosition(sf::Vector2f(std::min(selectionStart.x, selectionEnd.x), std::min(selectionStart.y, selectionEnd.y)));
+            selectionEnd = camera.toWorld(mousePos);
+            updateSelection();
         }
     }
 
+    // Reshapes the selection to end at selectionEnd and re-rasterizes it onto the grid. A lasso
+    // gains a vertex once the cursor has moved half a tile from the last one.
+    void updateSelection() {
+        sf::Vector2f d = selectionEnd - selectionStart;
+        switch (selectionShape) {
+            case Region::Rect:
+                selection = Region::rect(sf::FloatRect(std::min(selectionStart.x, selectionEnd.x), std::min(selectionStart.y, selectionEnd.y),
+                                                       std::abs(d.x), std::abs(d.y)));
+                break;
+            case Region::Circle: selection = Region::circle(selectionStart, std::sqrt(d.x * d.x + d.y * d.y)); break;
+            case Region::Polygon: {
+                sf::Vector2f step = selectionEnd - selection.points.back();
+                float minStep = 0.5f * sim.grid().cellSize;
+                if (step.x * step.x + step.y * step.y < minStep * minStep) return;
+                selection.points.push_back(selectionEnd);
+                break;
+            }
+        }
+        selectionSpans = selection.spans(sim.grid());
+    }
+
+    void cycleSelectionShape() {
+        static const char *names[] = {"rectangle", "circle", "lasso"};
+        selectionShape = (Region::Shape)((selectionShape + 1) % 3);
+        std::cout << "Selection shape: " << names[selectionShape] << "\n";
+    }
+
     void handleMouseReleased(sf::Vector2i mousePos) {
+        camera.endDrag();
         if (selectionState == SelectionState::Selecting) {
-            selectionEnd = sf::Vector2f((float)mousePos.x, (float)mousePos.y);
+            selectionEnd = camera.toWorld(mousePos);
+            updateSelection();
             selectionState = SelectionState::Selected;
             showAnalysisPopup = true;
 
@@ -838,39 +1073,52 @@ class FarmScene {
         }
     }
 
-    // ---------------- Draw selection rectangle ----------------
+    // ---------------- Draw selection (world view) ----------------
+    // The cells the selection covers, one quad per span, under the outline of the shape
     void drawSelection() {
-        if (selectionState == SelectionState::Selecting || selectionState == SelectionState::Selected) {
-            window.draw(selectionRect);
+        if (selectionState != SelectionState::Selecting && selectionState != SelectionState::Selected) return;
+        const FarmGrid &grid = sim.grid();
+        const sf::Color fill(0, 0, 255, 50);
+        sf::VertexArray cells(sf::Quads, selectionSpans.size() * 4);
+        for (std::size_t i = 0; i < selectionSpans.size(); i++) {
+            const CellSpan &span = selectionSpans[i];
+            sf::Vector2f a = grid.worldOf(span.x0, span.y), b = grid.worldOf(span.x1, span.y + 1);
+            cells[i * 4 + 0] = sf::Vertex(a, fill);
+            cells[i * 4 + 1] = sf::Vertex(sf::Vector2f(b.x, a.y), fill);
+            cells[i * 4 + 2] = sf::Vertex(b, fill);
+            cells[i * 4 + 3] = sf::Vertex(sf::Vector2f(a.x, b.y), fill);
         }
+        window.draw(cells);
+
+        std::vector<sf::Vector2f> outline = selection.outline();
+        sf::VertexArray line(sf::LineStrip, outline.size() + 1);
+        for (std::size_t i = 0; i <= outline.size(); i++) line[i] = sf::Vertex(outline[i % outline.size()], sf::Color::Blue);
+        if (!outline.empty()) window.draw(line);
+    }
 
+    // ---------------- Draw analysis popup (screen view) ----------------
+    void drawAnalysisPopup() {
         if (showAnalysisPopup) {
-            // Draw popup
+            // Draw popup above the selection, anchored to its on-screen position
+            sf::FloatRect bounds = selection.bounds();
+            sf::Vector2i anchor = window.mapCoordsToPixel(sf::Vector2f(bounds.left, bounds.top), camera.getView());
             sf::RectangleShape popup(sf::Vector2f(250.f, 80.f));
             popup.setFillColor(sf::Color(50, 50, 50, 230));
             popup.setOutlineColor(sf::Color::White);
             popup.setOutlineThickness(2.f);
-            popup.setPosition(selectionRect.getPosition().x, selectionRect.getPosition().y - 130.f);  // above selection
+            popup.setPosition((float)anchor.x, (float)anchor.y - 130.f);  // above selection
             window.draw(popup);
 
             // ---------------- Collect tiles inside selection ----------------
-            sf::FloatRect selRect = selectionRect.getGlobalBounds();
-
             std::vector<std::tuple<int, int>> selectedTiles;  // landIndex, tileIndex, cropName
             float quality = 0.0f;
-            for (int landIdx = 0; landIdx < (int)lands.size(); ++landIdx) {
-                auto &land = lands[landIdx];
-
-                for (int tileIdx = 0; tileIdx < (int)land.tiles.size(); ++tileIdx) {
-                    const auto &tile = land.tiles[tileIdx];
-                    sf::FloatRect tileRect(tile.position, sf::Vector2f(tile.size, tile.size));
-
-                    if (selRect.intersects(tileRect)) {
-                        quality += land.computeSoilQuality(tile, tile.cropType);
-                        selectedTiles.emplace_back(landIdx, tileIdx);
-                    }
-                }
-            }
+            const FrameSnapshot &frame = sim.snapshot();
+            sim.grid().forEachTile(selectionSpans, [&](int landIdx, int tileIdx) {
+                if (landIdx >= (int)frame.lands.size() || frame.lands[landIdx].tiles.size() != lands[landIdx].tiles.size()) return;
+                const TileVisual &visual = frame.lands[landIdx].tiles[tileIdx];
+                quality += lands[landIdx].computeSoilQuality(tileIdx, visual.cropId, visual.waterLevel);
+                selectedTiles.emplace_back(landIdx, tileIdx);
+            });
 
             sf::Text text("Soil Average Quality: " + std::to_string((quality / (selectedTiles.size()))), font, 14);
             text.setFillColor(sf::Color::White);
@@ -891,80 +1139,70 @@ class FarmScene {
 
     // ---------------- Analyze selected area ----------------
     void analyzeSelectedArea() {
-        sf::FloatRect area(selectionRect.getPosition(), selectionRect.getSize());
-
         // TODO: Arka api
-        Point topLeft{area.left, area.top};
-        Point bottomRight{area.left + area.width, area.top + area.height};
+        std::vector<CellSpan> cells = selectionSpans;
+        for (auto &span : cells) {  // input/land.csv coordinates
+            span.y += sim.grid().origin.y;
+            span.x0 += sim.grid().origin.x;
+            span.x1 += sim.grid().origin.x;
+        }
 
-        std::cout << "Selected area: Topleft={" << topLeft.x << "," << topLeft.y << "}, BottomRight={" << bottomRight.x << "," << bottomRight.y
-                  << "}\n";
+        sf::FloatRect bounds = selection.bounds();
+        std::cout << "Selected area: " << Region::cellCount(cells) << " cells in rows " << (cells.empty() ? 0 : cells.front().y) << " to "
+                  << (cells.empty() ? 0 : cells.back().y) << ", bounds (" << bounds.left << "," << bounds.top << ") " << bounds.width << "x"
+                  << bounds.height << "\n";
 
-        bestCrop = evaluator.getBestCropForArea(topLeft, bottomRight);
+        bestCrop = evaluator.getBestCropForArea(cells);
     }
 
     void clearSelection() {
         selectAreaActive = false;
         selectionState = SelectionState::None;              // Reset state
         showAnalysisPopup = false;                          // Hide popup
-        selectionRect.setSize(sf::Vector2f(0.f, 0.f));      // Clear rectangle
-        selectionRect.setPosition(sf::Vector2f(0.f, 0.f));  // Reset position
+        selection = Region();                               // Clear shape
+        selectionSpans.clear();                             // and its cells
     }
 
-    void writeSimulationOutput(const std::string &filename) {
-        std::ofstream out(filename, std::ios::app);  // <-- append mode
-        if (!out.is_open()) {
-            std::cerr << "Failed to open output file: " << filename << "\n";
-            return;
-        }
+    // ---------------- Weather ----------------
+    // Toggles replaying Config::weatherFile; it follows simulated time from the next Start
+    void toggleWeather() {
+        weatherEnabled = !weatherEnabled;
+        SimCommand command{SimCommand::LoadWeather};
+        command.enable = weatherEnabled;
+        sim.post(command);
+    }
 
-        // Write header only if file is empty
-        static bool headerWritten = false;
-        if (!headerWritten) {
-            out << "LandIndex,TileX,TileY,CropName,Growth,TimeToMature,SoilQuality\n";
-            headerWritten = true;
-        }
+    // O key: off -> soil quality -> water -> growth -> each soil factor -> off
+    void cycleOverlay() {
+        overlay.cycle();
+        std::cout << "Overlay: " << overlay.name() << "\n";
+    }
 
-        for (int landIdx = 0; landIdx < (int)lands.size(); ++landIdx) {
-            const auto &land = lands[landIdx];
-            for (const auto &tile : land.tiles) {
-                if (!tile.hasCrop) continue;
-                float maturity = (tile.timeToMature >= 0.f) ? tile.timeToMature : simClock.getElapsedTime().asSeconds();
-                if (tile.crop.growth >= 1.f) {
-                    out << landIdx << "," << tile.position.x << "," << tile.position.y << "," << tile.cropType.name << "," << std::fixed
-                        << std::setprecision(2) << tile.crop.growth << "," << maturity << "," << tile.soilQuality << "\n";
-                }
-            }
-        }
+    void toggleDiffusion() {
+        diffusionEnabled = !diffusionEnabled;
+        SimCommand command{SimCommand::SetDiffusion};
+        command.enable = diffusionEnabled;
+        sim.post(command);
+    }
 
-        out.close();
-        std::cout << "Simulation output appended to " << filename << "\n";
+    // ---------------- Checkpoint ----------------
+    void saveCheckpoint() { sim.post({SimCommand::SaveCheckpoint}); }
+
+    void restoreCheckpoint() {
+        clearSelection();
+        restoreTicket = sim.post({SimCommand::RestoreCheckpoint});
     }
 
     void reset() {
         simulate = false;
         rainActive = false;
-        alreadySelectionInProgress = false;
         raindrops.clear();
         splashes.clear();
         ripples.clear();
 
         clearSelection();
         analysisRequested = false;
-        for (auto &land : lands) {
-            for (auto &tile : land.tiles) {
-                tile.hasCrop = false;
-                tile.crop.growth = 0.f;
-                tile.crop.shape.setSize(sf::Vector2f(tile.size, tile.size) * Config::cropInitialScale);
-                tile.crop.shape.setPosition(tile.position.x + (tile.size - tile.size * Config::cropInitialScale) / 2,
-                                            tile.position.y + (tile.size - tile.size * Config::cropInitialScale) / 2);
-                tile.waterLevel = 0.f;
-                tile.soilQuality = 0.f;
-                tile.timeToMature = -1.f;
-            }
-            // land.plantCrops(cropTypes[selectedCropIndex]);
-        }
-        simClock.restart();
+        sim.post({SimCommand::Reset});
     }
 };
 
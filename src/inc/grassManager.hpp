@@ -2,59 +2,41 @@
 #define GRASS_MANAGER_HPP_
 
 #include "config.hpp"
+#include "resources.hpp"
 
 namespace Harvestor {
 // ---------------- GrassManager ----------------
 class GrassManager {
-    sf::Texture texture;
+    TextureHandle texture;  // ResourceCache crop; the decode is shared with Land's farmland crop
     float tileSize;
-    std::vector<sf::Sprite> grassSprites;
 
    public:
     GrassManager(const std::string &filePath, float tileSize) : tileSize(tileSize) {
-        sf::Image img;
-        if (!img.loadFromFile(filePath)) {
-            std::cerr << "Failed to load grass texture from " << filePath << std::endl;
-            return;
-        }
-
-        // Crop left 10% of the texture
-        unsigned int cropWidth = img.getSize().x / 10;  // 10% width
-        unsigned int cropHeight = img.getSize().y;      // full height
-        sf::IntRect cropRect(0, 0, cropWidth, cropHeight);
-
-        sf::Image cropped;
-        cropped.create(cropWidth, cropHeight, sf::Color::Transparent);
-        cropped.copy(img, 0, 0, cropRect, true);
-
-        if (!texture.loadFromImage(cropped)) {
-            std::cerr << "Failed to load cropped texture!" << std::endl;
-        }
-
-        texture.setRepeated(true);
-        texture.setSmooth(true);
+        // Crop left 10% of the texture, full height
+        texture = ResourceCache::get().request(filePath, "grass", [](sf::Vector2u size) { return sf::IntRect(0, 0, size.x / 10, size.y); });
     }
 
-    void generate(float width, float height) {
-        grassSprites.clear();
-        for (float y = 0; y < height; y += tileSize) {
-            for (float x = Config::uiPanelWidth; x < width; x += tileSize) {
-                sf::Sprite sprite;
-                sprite.setTexture(texture);
-
-                // Use full texture (cropped left 10%)
-                sf::Vector2u texSize = texture.getSize();
-                sprite.setTextureRect(sf::IntRect(0, 0, texSize.x, texSize.y));
-                sprite.setScale(tileSize / float(texSize.x), tileSize / float(texSize.y));
-                sprite.setPosition(x + rand() % 2, y + rand() % 2);
-
-                grassSprites.push_back(sprite);
-            }
-        }
-    }
-
-    void draw(sf::RenderWindow &window) {
-        for (auto &g : grassSprites) window.draw(g);
+    // Grass is one repeated-texture quad covering whatever the current view shows, so its cost
+    // does not grow with the world size.
+    void draw(sf::RenderTarget &target) {
+        const sf::Texture *tex = ResourceCache::get().texture(texture);
+        if (!tex) return;  // still loading
+        sf::Vector2u texSize = tex->getSize();
+
+        const sf::View &view = target.getView();
+        sf::Vector2f size = view.getSize();
+        sf::Vector2f topLeft = view.getCenter() - size / 2.f;
+
+        // tileSize world units map onto one full copy of the texture
+        float texelsPerUnitX = texSize.x / tileSize;
+        float texelsPerUnitY = texSize.y / tileSize;
+
+        sf::RectangleShape grass(size);
+        grass.setPosition(topLeft);
+        grass.setTexture(tex);
+        grass.setTextureRect(sf::IntRect((int)std::floor(topLeft.x * texelsPerUnitX), (int)std::floor(topLeft.y * texelsPerUnitY),
+                                         (int)std::ceil(size.x * texelsPerUnitX), (int)std::ceil(size.y * texelsPerUnitY)));
+        target.draw(grass);
     }
 };
 
@@ -0,0 +1,264 @@
+#ifndef HEADLESS_HPP_
+#define HEADLESS_HPP_
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "evaluator.hpp"
+#include "loader.hpp"
+#include "mapExport.hpp"
+#include "simulation.hpp"
+
+namespace Harvestor {
+// ---------------- Headless ----------------
+// Simulation runs without a window, from the command line (see main.cpp)
+class Headless {
+   public:
+    // Loads the default farm (Config::landFile and Config::waterFile), plants `cropName` everywhere (first crop if empty or unknown) and
+    // steps the simulation at Config::seasonStepSeconds until the weather series ends
+    static int season(const std::string &weatherFile, const std::string &cropName) {
+        CropRegistry &crops = CropRegistry::get();
+        crops.loadFromFile(Config::cropsFile);
+        CropId crop = crops.idOf(cropName);
+        if (!crops.valid(crop)) crop = 0;
+
+        LayoutArena arena;
+        std::vector<Land> lands;
+        std::vector<Pond> ponds;
+        FarmLoader::loadFromCsv(Config::landFile, Config::waterFile, lands, ponds, crop, arena.resource());
+        if (lands.empty()) return 1;
+
+        Simulation sim(lands, ponds);
+        sim.layoutChanged();
+        if (!sim.weather.load(weatherFile)) return 1;
+        sim.apply({SimCommand::SetSimulate, true});
+
+        std::cout << "Season run: " << crops.name(crop) << " on " << sim.lands[0].tiles.size() << " tiles, weather " << weatherFile << "\n";
+        std::cout << std::fixed << std::setprecision(1);
+        SeasonRun run = runSeason(sim, [&](int day) {
+            if (day % 7 == 0) report("  day " + std::to_string(day + 1), sim);
+        });
+
+        report("  end", sim);
+        std::cout << "  " << run.steps << " steps, " << sim.state.simTime / Config::weatherHourSeconds << " weather hours, " << run.rain
+                  << " mm rain\n";
+        std::cout << "  wall time " << std::setprecision(2) << run.seconds << " s (" << run.steps / std::max(run.seconds, 1e-9) << " steps/s)\n"
+                  << std::defaultfloat;
+
+        if (!Config::exportDir.empty()) exportMaps(Config::exportDir, sim);
+        return 0;
+    }
+
+    // What-if replanting: from the state in Config::checkpointFile (a freshly planted farm if there is
+    // none), replants the cells `cells` (input/land.csv coordinates) once with their current crops and
+    // once with `cropName`, and steps only those tiles forward on the region's own clock until they
+    // mature or Config::whatIfMaxSeconds pass. The rest of the farm is never simulated.
+    static int whatIf(const std::string &cropName, const sf::IntRect &cells) {
+        CropRegistry &crops = CropRegistry::get();
+        crops.loadFromFile(Config::cropsFile);
+        CropId crop = crops.idOf(cropName);
+        if (!crops.valid(crop)) {
+            std::cerr << "Unknown crop for what-if: " << cropName << "\n";
+            return 1;
+        }
+
+        LayoutArena arena;
+        std::vector<Land> lands;
+        std::vector<Pond> ponds;
+        FarmLoader::loadFromCsv(Config::landFile, Config::waterFile, lands, ponds, 0, arena.resource());
+        if (lands.empty()) return 1;
+
+        Simulation sim(lands, ponds);
+        sim.layoutChanged();
+        bool restored = std::filesystem::exists(Config::checkpointFile) && sim.checkpoint.restore(Config::checkpointFile, lands, sim.state);
+        float cs = sim.grid.cellSize;
+        std::vector<CellSpan> spans = Region::rect(sf::FloatRect(cells.left * cs, cells.top * cs, cells.width * cs, cells.height * cs)).spans(sim.grid);
+
+        // Both scenarios start from the same tiles
+        std::vector<std::pair<int, Tile>> saved;
+        sim.grid.forEachTile(spans, [&](int l, int i) { saved.emplace_back(l, lands[l].tiles[i]); });
+        if (saved.empty()) {
+            std::cerr << "No land tiles in cells (" << cells.left << "," << cells.top << ") " << cells.width << "x" << cells.height << "\n";
+            return 1;
+        }
+        std::size_t farmTiles = 0;
+        for (const auto &land : lands) farmTiles += land.tiles.size();
+        std::cout << "What-if on " << saved.size() << " of " << farmTiles << " tiles from " << (restored ? Config::checkpointFile : "a fresh farm")
+                  << " at t = " << sim.state.simTime << " s\n";
+
+        for (CropId scenario : {kNoCrop, crop}) {
+            auto it = saved.begin();
+            sim.grid.forEachTile(spans, [&](int l, int i) { lands[l].tiles[i] = (it++)->second; });
+            sim.replant(spans, scenario);
+
+            auto start = std::chrono::steady_clock::now();
+            RegionRun run(lands, sim.grid, spans, sim.state.simTime, sim.state.step, sim.state.seed);
+            std::uint64_t steps = 0;
+            while (run.time - sim.state.simTime < Config::whatIfMaxSeconds && !run.matured()) {
+                run.advance(Config::seasonStepSeconds);
+                steps++;
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            LandStats stats = run.stats();
+            std::cout << "  " << (scenario == kNoCrop ? "current crops" : crops.name(crop)) << ": matured " << stats.maturedTiles << "/"
+                      << stats.cropTiles << ", mean time to mature " << run.meanTimeToMature() << " s, " << steps << " steps in " << std::fixed
+                      << std::setprecision(3) << seconds << " s\n"
+                      << std::defaultfloat;
+        }
+        return 0;
+    }
+
+    // A width x height land.csv (x,y and the seven soil factors per tile) with coherent soil from
+    // SoilNoise, in place of report/gen.py and the random soil of report/map_generator.py
+    static int generateSoil(int width, int height, const std::string &path) {
+        if (width <= 0 || height <= 0) {
+            std::cerr << "Soil grid must be at least 1x1\n";
+            return 1;
+        }
+        auto start = std::chrono::steady_clock::now();
+        BasicSoilStore<float> soil;
+        SoilNoise().fillGrid(width, height, soil);
+        double generated = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Failed to open " << path << " for writing\n";
+            return 1;
+        }
+        out << "x,y,soilBaseQuality,sunlight,nutrients,pH,organicMatter,compaction,salinity\n";
+        std::string buffer;
+        char row[128];
+        for (std::size_t i = 0; i < soil.size(); i++) {
+            SoilSample s = soil.sample(i);
+            int len = std::snprintf(row, sizeof(row), "%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", (int)(i % width), (int)(i / width), s.soilBaseQuality,
+                                    s.sunlight, s.nutrients, s.pH, s.organicMatter, s.compaction, s.salinity);
+            buffer.append(row, len);
+            if (buffer.size() > (1u << 20)) {
+                out << buffer;
+                buffer.clear();
+            }
+        }
+        out << buffer;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Wrote " << soil.size() << " tiles to " << path << " (generated in " << std::fixed << std::setprecision(3) << generated << " s, "
+                  << seconds << " s in total)\n"
+                  << std::defaultfloat;
+        return out ? 0 : 1;
+    }
+
+    // Expected footprint of a farm on a width x height cell grid with the given land and pond tile
+    // counts, before anything is loaded. Render buffers assume every chunk drawn close up once and
+    // every crop visible; the moisture grid only counts with diffusion on.
+    static MemoryReport estimateMemory(int width, int height, std::size_t landTiles, std::size_t waterTiles) {
+        MemoryReport report;
+        report.tiles = landTiles;
+        const std::size_t cells = (std::size_t)std::max(width, 0) * std::max(height, 0);
+        const std::size_t chunkTiles = (std::size_t)Config::chunkSize * Config::chunkSize;
+        const std::size_t chunks = (landTiles + chunkTiles - 1) / chunkTiles;
+
+        report.add(TileStorage, "land tiles", landTiles * sizeof(Tile));
+        report.add(TileStorage, "soil factors", landTiles * SoilStore::bytesPerTile());
+        report.add(TileStorage, "pond coverage", landTiles * sizeof(float));
+        report.add(TileStorage, "land chunks", chunks * sizeof(LandChunk));
+        report.add(TileStorage, "pond tiles", waterTiles * sizeof(PondTile));
+
+        report.add(RenderBuffers, "farmland quads", landTiles * 4 * sizeof(sf::Vertex));
+        report.add(RenderBuffers, "crop quads", landTiles * 4 * sizeof(sf::Vertex));
+        report.add(RenderBuffers, "chunk textures (GPU)", chunks * chunkTiles * 4 * 4);  // LOD, overlay and two soil textures
+        report.add(RenderBuffers, "frame snapshots", 3 * landTiles * sizeof(TileVisual));
+
+        report.add(ParticlePools, "raindrops", (std::size_t)Config::numRaindrops * sizeof(RainDrop));
+        report.add(EvaluatorIndices, "soil and best crop by cell", landTiles * Evaluator::bytesPerCell());
+
+        report.add(Caches, "farm grid", cells * FarmGrid::bytesPerCell());
+        if (Config::moistureDiffusion) report.add(Caches, "moisture grid", (std::size_t)(width + 2) * (height + 2) * 6 * sizeof(float));
+        return report;
+    }
+
+    // --mem-report: the default farm (or `layout`) loaded, stepped once and indexed by an Evaluator as
+    // the window would, against the estimate for the same grid. Headless, so render buffers stay empty.
+    static int memoryReport(const std::string &layout) {
+        CropRegistry::get().loadFromFile(Config::cropsFile);
+        LayoutArena arena;
+        std::vector<Land> lands;
+        std::vector<Pond> ponds;
+        if (layout.empty())
+            FarmLoader::loadFromCsv(Config::landFile, Config::waterFile, lands, ponds, 0, arena.resource());
+        else
+            FarmLoader::loadFromFile(layout, lands, ponds, 0, arena.resource());
+        if (lands.empty()) return 1;
+
+        Simulation sim(lands, ponds);
+        sim.layoutChanged();
+        sim.apply({SimCommand::SetSimulate, true});
+        sim.step(Config::seasonStepSeconds);
+        Evaluator evaluator;
+        evaluator.updateSoilData(Config::landFile);
+
+        MemoryReport report;
+        sim.reportMemory(report);
+        arena.reportMemory(report);
+        evaluator.reportMemory(report);
+        report.print(std::cout, "Memory in use (" + (layout.empty() ? Config::landFile : layout) + ")");
+
+        std::size_t waterTiles = 0;
+        for (const auto &pond : ponds) waterTiles += pond.tiles.size();
+        estimateMemory(sim.grid.width, sim.grid.height, report.tiles, waterTiles)
+            .print(std::cout, "Estimate for " + std::to_string(sim.grid.width) + "x" + std::to_string(sim.grid.height) + " cells with a window");
+        return 0;
+    }
+
+    struct SeasonRun {
+        std::uint64_t steps = 0;
+        double rain = 0.0;     // mm
+        double seconds = 0.0;  // wall time
+    };
+
+    // Steps `sim` (weather loaded, simulating) at Config::seasonStepSeconds until the weather series
+    // ends; onDay(day) is called once per new day
+    template <typename Fn>
+    static SeasonRun runSeason(Simulation &sim, Fn &&onDay) {
+        SeasonRun run;
+        auto start = std::chrono::steady_clock::now();
+        int lastDay = -1;
+        for (;;) {
+            sim.step(Config::seasonStepSeconds);
+            if (!sim.weather.active()) break;
+            run.steps++;
+            run.rain += sim.weather.current().rain * Config::seasonStepSeconds / Config::weatherHourSeconds;
+
+            int day = (int)(sim.weather.current().hour / 24.f);
+            if (day != lastDay) {
+                onDay(day);
+                lastDay = day;
+            }
+        }
+        run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return run;
+    }
+
+    // Every MapLayer of the current state as a PNG mosaic in `dir`
+    static void exportMaps(const std::string &dir, const Simulation &sim) {
+        MapExporter exporter(sim.lands, sim.grid);
+        for (int l = 0; l < (int)MapLayer::NumLayers; l++) {
+            MapExportStats stats = exporter.write(dir, (MapLayer)l);
+            std::cout << "  exported " << mapLayerName((MapLayer)l) << ": " << stats.width << "x" << stats.height << " px in " << stats.tiles << " tile(s), "
+                      << std::fixed << std::setprecision(2) << stats.seconds << " s\n"
+                      << std::defaultfloat;
+        }
+    }
+
+   private:
+    static void report(const std::string &label, const Simulation &sim) {
+        LandStats stats;
+        for (const auto &land : sim.lands) stats += land.stats;
+        std::cout << label << ": growth " << stats.avgGrowth() * 100.f << "%, matured " << stats.maturedPercentage() << "%, water "
+                  << stats.avgWater() << ", " << sim.weather.current().temperature << " C\n";
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef IRRIGATION_HPP_
+#define IRRIGATION_HPP_
+
+#include "parallel.hpp"
+#include "tileRaster.hpp"
+
+namespace Harvestor {
+// ---------------- IrrigationPlan ----------------
+struct IrrigationPlan {
+    std::vector<sf::Vector2f> sources;  // world position (top-left) of each new single-tile water source
+    double meanTtmBefore = 0.0;         // seconds, mean over all land tiles
+    double meanTtmAfter = 0.0;
+    std::size_t candidates = 0;   // cells a source could go to
+    std::size_t evaluations = 0;  // candidate scores computed
+};
+
+// ---------------- IrrigationOptimizer ----------------
+// Chooses where to dig new water sources so the whole farm matures fastest for one crop. Sources go
+// to cells holding neither a land tile nor a pond (gaps between and around fields).
+// Every tile is scored at its water equilibrium (TileRaster::timeToMature), and on the farm grid a
+// source only affects the cells within its reach: greedy selection re-scores just the candidates
+// near the last pick, and a local search then moves each source within its neighbourhood.
+// Candidate scoring is spread over all cores. `grid` must be built from the lands and current
+// ponds, and neither may change while it runs.
+class IrrigationOptimizer {
+   public:
+    IrrigationOptimizer(const std::vector<Land> &lands, const FarmGrid &grid, CropId crop, float sourceSize = Config::landTileSize)
+        : crop(crop), raster(lands, grid) {
+        buildKernel(sourceSize);
+        coverage = raster.grid.pondCoverage;
+        blocked = raster.grid.waterMask;
+        // A source goes to a free cell: digging one on a land tile would leave that tile growing under
+        // the water and count its own TTM in the gain
+        candidateAt.assign(raster.grid.cells(), -1);
+        for (std::size_t c = 0; c < raster.grid.cells(); c++) {
+            if (blocked[c] || raster.cellStart[c] != raster.cellStart[c + 1]) continue;
+            candidateAt[c] = (int)candidates.size();
+            candidates.push_back((int)c);
+        }
+
+        ttm.resize(raster.tiles.size());
+        if (CropRegistry::get().valid(crop)) {
+            for (std::size_t t = 0; t < ttm.size(); t++) ttm[t] = TileRaster::timeToMature(raster.tileQuality[t], coverage[raster.tileCell[t]], crop);
+        }
+    }
+
+    // Places up to `count` sources; stops early when no position shortens maturity any further
+    IrrigationPlan optimize(int count) {
+        IrrigationPlan plan;
+        plan.meanTtmBefore = meanTtm();
+        if (ttm.empty() || !CropRegistry::get().valid(crop)) {
+            plan.meanTtmAfter = plan.meanTtmBefore;
+            return plan;
+        }
+
+        // ---------------- Greedy ----------------
+        std::vector<int> all(candidates.size());
+        for (std::size_t i = 0; i < all.size(); i++) all[i] = (int)i;
+        gains.assign(candidates.size(), 0.0);
+        score(all);
+        plan.candidates = candidates.size();
+
+        for (int k = 0; k < count; k++) {
+            int best = -1;
+            for (std::size_t i = 0; i < candidates.size(); i++) {
+                if (!blocked[candidates[i]] && gains[i] > 0.0 && (best < 0 || gains[i] > gains[best])) best = (int)i;
+            }
+            if (best < 0) break;
+            place(candidates[best]);
+            score(candidatesNear(candidates[best], 2 * reachCells));  // only these can see the new source
+        }
+
+        // ---------------- Local search ----------------
+        for (int pass = 0; pass < Config::irrigationSearchPasses; pass++) {
+            bool moved = false;
+            for (std::size_t s = 0; s < sources.size(); s++) {
+                int from = sources[s];
+                remove(s);
+                std::vector<int> window = candidatesNear(from, reachCells);
+                score(window);
+                int best = candidateAt[from];
+                for (int i : window) {
+                    if (!blocked[candidates[i]] && gains[i] > gains[best] * (1.0 + 1e-6)) best = i;
+                }
+                place(candidates[best], s);
+                moved |= candidates[best] != from;
+            }
+            if (!moved) break;
+        }
+
+        for (int cell : sources) plan.sources.push_back(raster.worldPosition(cell));
+        plan.meanTtmAfter = meanTtm();
+        plan.evaluations = evaluations;
+        return plan;
+    }
+
+   private:
+    struct KernelCell {
+        int dx, dy;
+        float coverage;
+    };
+
+    CropId crop;
+    TileRaster raster;
+    float sourceReach = 0.f;  // world units
+    int reachCells = 0;
+    std::vector<KernelCell> kernel;  // coverage of a new source around its cell, zero entries dropped
+
+    std::vector<float> ttm;             // per raster tile, at the current coverage
+    std::vector<float> coverage;        // per cell: existing ponds plus placed sources
+    std::vector<std::uint8_t> blocked;  // per cell: holds a pond tile or a placed source
+    std::vector<int> candidates;        // grid cells
+    std::vector<int> candidateAt;       // grid cell -> candidate index, -1 if none
+    std::vector<double> gains;          // per candidate: total TTM saved by placing a source there
+    std::vector<int> sources;           // grid cells of placed sources
+    std::size_t evaluations = 0;
+
+    void buildKernel(float sourceSize) {
+        sourceReach = sourceSize * Land::pondReach;
+        reachCells = (int)std::ceil(sourceReach / raster.grid.cellSize);
+        for (int dy = -reachCells; dy <= reachCells; dy++) {
+            for (int dx = -reachCells; dx <= reachCells; dx++) {
+                float c = 1.f - std::sqrt((float)(dx * dx + dy * dy)) * raster.grid.cellSize / sourceReach;
+                if (c > 0.f) kernel.push_back({dx, dy, c});
+            }
+        }
+    }
+
+    // TTM saved over the whole farm if a source went to grid cell `at`; touches only its reach
+    double gainAt(int at) const {
+        int ax = at % raster.grid.width, ay = at / raster.grid.width;
+        double gain = 0.0;
+        for (const auto &k : kernel) {
+            int x = ax + k.dx, y = ay + k.dy;
+            if (!raster.grid.inside(x, y)) continue;
+            int c = raster.grid.index(x, y);
+            if (k.coverage <= coverage[c]) continue;
+            for (int t = raster.cellStart[c]; t < raster.cellStart[c + 1]; t++)
+                gain += ttm[t] - TileRaster::timeToMature(raster.tileQuality[t], k.coverage, crop);
+        }
+        return gain;
+    }
+
+    void score(const std::vector<int> &ids) {
+        parallelFor(ids.size(), [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) gains[ids[i]] = gainAt(candidates[ids[i]]);
+        });
+        evaluations += ids.size();
+    }
+
+    std::vector<int> candidatesNear(int at, int radius) const {
+        std::vector<int> ids;
+        int ax = at % raster.grid.width, ay = at / raster.grid.width;
+        for (int y = std::max(0, ay - radius); y <= std::min(raster.grid.height - 1, ay + radius); y++) {
+            for (int x = std::max(0, ax - radius); x <= std::min(raster.grid.width - 1, ax + radius); x++) {
+                if (candidateAt[raster.grid.index(x, y)] >= 0) ids.push_back(candidateAt[raster.grid.index(x, y)]);
+            }
+        }
+        return ids;
+    }
+
+    // Adds a source (or puts source `slot` back) and raises coverage around it
+    void place(int at, std::size_t slot = SIZE_MAX) {
+        if (slot < sources.size())
+            sources[slot] = at;
+        else
+            sources.push_back(at);
+        blocked[at] = 1;
+        refresh(at);
+    }
+
+    // Takes source `slot` out; its cell is re-placed by the caller
+    void remove(std::size_t slot) {
+        int at = sources[slot];
+        sources[slot] = -1;
+        blocked[at] = 0;
+        refresh(at);
+    }
+
+    // Recomputes coverage and TTM of the cells within reach of `at` from the ponds and placed sources
+    void refresh(int at) {
+        int ax = at % raster.grid.width, ay = at / raster.grid.width;
+        for (const auto &k : kernel) {
+            int x = ax + k.dx, y = ay + k.dy;
+            if (!raster.grid.inside(x, y)) continue;
+            int c = raster.grid.index(x, y);
+            float cov = raster.grid.pondCoverage[c];
+            for (int s : sources) {
+                if (s < 0) continue;
+                int dx = x - s % raster.grid.width, dy = y - s / raster.grid.width;
+                if (std::abs(dx) > reachCells || std::abs(dy) > reachCells) continue;
+                cov = std::max(cov, 1.f - std::sqrt((float)(dx * dx + dy * dy)) * raster.grid.cellSize / sourceReach);
+            }
+            if (cov == coverage[c]) continue;
+            coverage[c] = cov;
+            for (int t = raster.cellStart[c]; t < raster.cellStart[c + 1]; t++) ttm[t] = TileRaster::timeToMature(raster.tileQuality[t], cov, crop);
+        }
+    }
+
+    double meanTtm() const {
+        double sum = 0.0;
+        for (float t : ttm) sum += t;
+        return ttm.empty() ? 0.0 : sum / ttm.size();
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
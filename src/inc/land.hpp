@@ -2,81 +2,253 @@
 #define LAND_HPP_
 
 #include <SFML/Graphics/Color.hpp>
+#include <mutex>
 
+#include "chunk.hpp"
 #include "common.hpp"
+#include "cropRegistry.hpp"
 #include "normalizer.hpp"
+#include "overlay.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+#include "resources.hpp"
+#include "soil.hpp"
 
 namespace Harvestor {
+// ---------------- LandChunk ----------------
+// Simulation thread writes `version`; render thread owns the geometry, texture and bakedVersion.
+struct LandChunk {
+    ChunkRange range;                   // tiles[range.begin, range.end)
+    std::uint32_t version = 1;          // bumped whenever a tile of the chunk changes
+    sf::VertexArray ground{sf::Quads};  // farmland quads, built on first close-up draw
+    sf::Texture lodTexture;             // one texel per tile, drawn when zoomed out
+    std::uint32_t bakedVersion = 0;     // version lodTexture was baked from
+    std::uint32_t savedVersion = 0;     // version last written to the checkpoint file
+    sf::Texture overlayTexture;               // HeatmapOverlay attributes, one texel per tile
+    std::array<sf::Texture, 2> soilTextures;  // static soil factors for the overlay, baked once
+    std::uint32_t overlayVersion = 0;         // version overlayTexture was baked from
+};
+
+// ---------------- LandSnapshot ----------------
+// Render-relevant copy of a tile, published by the simulation thread
+struct TileVisual {
+    float growth = 0.f;
+    float waterLevel = 0.f;
+    sf::Color color;                // crop tint (cropColor)
+    CropId cropId = kNoCrop;
+    std::uint8_t batch = 0;         // Land::CropBatch, i.e. which texture the crop is drawn with
+    bool hasCrop = false;
+};
+
+struct LandSnapshot {
+    std::vector<TileVisual> tiles;             // indexed like Land::tiles
+    std::vector<std::uint32_t> chunkVersions;  // indexed like Land::chunks
+};
+
+// ---------------- LandStats ----------------
+// Running totals kept up to date by every tile mutation, so stats queries are O(1).
+struct LandStats {
+    double soilSum = 0.0;    // soil quality, over planted tiles
+    double waterSum = 0.0;   // water level, over all tiles
+    double growthSum = 0.0;  // growth, over planted tiles
+    int totalTiles = 0;
+    int cropTiles = 0;
+    int maturedTiles = 0;
+    std::vector<int> cropCounts;  // planted tiles per CropId
+
+    static LandStats fromTiles(const TileVector &tiles) {
+        LandStats stats;
+        for (const auto &tile : tiles) stats.add(tile);
+        return stats;
+    }
+
+    void add(const Tile &tile) {
+        totalTiles++;
+        waterSum += tile.waterLevel;
+        if (!tile.hasCrop) return;
+        cropTiles++;
+        soilSum += tile.soilQuality;
+        growthSum += tile.crop.growth;
+        if (tile.crop.growth >= 1.f) maturedTiles++;
+        if (tile.cropId >= cropCounts.size()) cropCounts.resize(tile.cropId + 1, 0);
+        cropCounts[tile.cropId]++;
+    }
+
+    // Undoes add(tile)
+    void remove(const Tile &tile) {
+        totalTiles--;
+        waterSum -= tile.waterLevel;
+        if (!tile.hasCrop) return;
+        cropTiles--;
+        soilSum -= tile.soilQuality;
+        growthSum -= tile.crop.growth;
+        if (tile.crop.growth >= 1.f) maturedTiles--;
+        if (tile.cropId < cropCounts.size()) cropCounts[tile.cropId]--;
+    }
+
+    LandStats &operator+=(const LandStats &o) {
+        soilSum += o.soilSum;
+        waterSum += o.waterSum;
+        growthSum += o.growthSum;
+        totalTiles += o.totalTiles;
+        cropTiles += o.cropTiles;
+        maturedTiles += o.maturedTiles;
+        if (o.cropCounts.size() > cropCounts.size()) cropCounts.resize(o.cropCounts.size(), 0);
+        for (std::size_t i = 0; i < o.cropCounts.size(); i++) cropCounts[i] += o.cropCounts[i];
+        return *this;
+    }
+
+    float avgSoil() const { return cropTiles > 0 ? (float)(soilSum / cropTiles) : 0.f; }
+    float avgWater() const { return totalTiles > 0 ? (float)(waterSum / totalTiles) : 0.f; }
+    float avgGrowth() const { return cropTiles > 0 ? (float)(growthSum / cropTiles) : 0.f; }
+    float maturedPercentage() const { return cropTiles > 0 ? (float)maturedTiles / cropTiles * 100.f : 0.f; }
+
+    // Running sums accumulate float rounding; counts must match exactly
+    bool matches(const LandStats &exact) const {
+        auto close = [&](double a, double b) { return std::abs(a - b) <= 1e-3 * std::max(1, exact.totalTiles); };
+        return close(soilSum, exact.soilSum) && close(waterSum, exact.waterSum) && close(growthSum, exact.growthSum) &&
+               totalTiles == exact.totalTiles && cropTiles == exact.cropTiles && maturedTiles == exact.maturedTiles;
+    }
+};
+
 // ---------------- Land ----------------
 class Land {
    public:
     sf::ConvexShape shape;
     sf::Vector2f center;
     float radius;
-    std::vector<Tile> tiles;
+    TileVector tiles;  // in the layout's arena, see LayoutArena
+    SoilStore soil;    // static soil factors, soil[i] belongs to tiles[i]
+    std::vector<LandChunk> chunks;
+    LandStats stats;  // running aggregates over tiles
     float tileSize;
-    sf::Texture farmlandTexture;
-    static sf::Texture wheatTexture;
-    static sf::Texture sugarcaneTexture;
-    static sf::Texture tomatoTexture;
-    bool loaded = false;
-
-    Land(float tileSize = Config::landTileSize) : tileSize(tileSize) {
-        // Load farmland texture once
-        if (!loaded) {
-            sf::Image img;
-            if (!img.loadFromFile("resources/combined.png")) {
-                std::cerr << "Failed to load farmland texture!" << std::endl;
-            } else {
-                // Crop center 5x5 area
-                sf::Vector2u size = img.getSize();
-                unsigned int cropSize = 5 * tileSize;  // 5x5 tiles in pixels
-                unsigned int x = (size.x - cropSize) / 2;
-                unsigned int y = (size.y - cropSize) / 2;
-
-                sf::IntRect centerRect(x, y, cropSize, cropSize);
-                sf::Image cropped;
-                cropped.create(cropSize, cropSize, sf::Color::Transparent);
-                cropped.copy(img, 0, 0, centerRect, true);
-
-                farmlandTexture.loadFromImage(cropped);
-                farmlandTexture.setRepeated(true);
-                farmlandTexture.setSmooth(true);
-                loaded = true;
-            }
-            if (!wheatTexture.loadFromFile("resources/wheat1.png")) {
-                std::cerr << "Failed to load water texture!" << std::endl;
-            } else {
-                wheatTexture.setRepeated(true);
-                wheatTexture.setSmooth(true);
-            }
-            if (!sugarcaneTexture.loadFromFile("resources/sugarcane.png")) {
-                std::cerr << "Failed to load water texture!" << std::endl;
-            } else {
-                sugarcaneTexture.setRepeated(true);
-                sugarcaneTexture.setSmooth(true);
-            }
-            if (!tomatoTexture.loadFromFile("resources/tomato.png")) {
-                std::cerr << "Failed to load water texture!" << std::endl;
-            } else {
-                tomatoTexture.setRepeated(true);
-                tomatoTexture.setSmooth(true);
-            }
-        }
+    TextureHandle farmlandTexture;  // ResourceCache crop of the ground texture
+    bool texturesRequested = false;
+    std::uint32_t rngId = 0;  // distinguishes this land's tiles in keyed random draws (land index)
+
+    // Per-frame crop quads, batched by texture: plain, wheat, tomato, sugarcane
+    enum CropBatch { PlainBatch = 0, WheatBatch, TomatoBatch, SugarcaneBatch, NumCropBatches };
+    std::array<sf::VertexArray, NumCropBatches> cropBatches{sf::VertexArray(sf::Quads), sf::VertexArray(sf::Quads), sf::VertexArray(sf::Quads),
+                                                            sf::VertexArray(sf::Quads)};
+    sf::Clock lodClock;
+    sf::Clock overlayClock;
+    std::vector<float> qualityScratch;  // per-chunk static soil quality, reused by updateGrowth
+    std::vector<float> noiseScratch;    // per-chunk growth variability, reused by updateGrowth
+    std::pmr::vector<float> pondCoverage;  // per tile, from FarmGrid::applyPondCoverage; missing = no pond nearby
+
+    // Water model: a pond tile pulls tiles within pondReach pond-tile sizes towards the crop's
+    // optimal water (linear falloff, see pondCoverage), at waterSpeed per second, minus evaporation per second
+    static constexpr float pondReach = 5.f;
+    static constexpr float waterSpeed = 0.5f;
+    static constexpr float evaporationRate = 0.01f;
+
+    // Tile, soil and coverage storage comes from `memory` (a LayoutArena when loaded from a layout)
+    Land(float tileSize = Config::landTileSize, std::pmr::memory_resource *memory = std::pmr::get_default_resource())
+        : tiles(memory), soil(memory), tileSize(tileSize), pondCoverage(memory) {}
+
+    // Textures are requested on first draw, so headless runs never touch the GPU. They are shared
+    // through ResourceCache: only the first land ever created decodes anything, in the background.
+    void loadTextures() {
+        if (texturesRequested) return;
+        texturesRequested = true;
+
+        // Center 5x5 tiles of the ground texture
+        int cropSize = (int)(5 * tileSize);  // 5x5 tiles in pixels
+        farmlandTexture = ResourceCache::get().request(Config::groundTexturePath, "farmland" + std::to_string(cropSize), [cropSize](sf::Vector2u size) {
+            if ((int)size.x < cropSize || (int)size.y < cropSize) return sf::IntRect();
+            return sf::IntRect(((int)size.x - cropSize) / 2, ((int)size.y - cropSize) / 2, cropSize, cropSize);
+        });
     }
 
-    void generateTiles(std::vector<Tile> ts) {
-        for (auto &t : ts) {
+    void generateTiles(std::vector<Tile> ts, const std::vector<SoilSample> &samples) {
+        tiles.reserve(tiles.size() + ts.size());
+        soil.reserve(soil.size() + ts.size());
+        for (std::size_t i = 0; i < ts.size(); i++) {
+            Tile &t = ts[i];
             t.size = Config::landTileSize;
             t.isInsideLand = true;
             t.hasCrop = false;
             t.waterLevel = 0.f;
             tiles.push_back(t);
+            soil.push_back(i < samples.size() ? samples[i] : SoilSample{});
         }
+        buildChunks();
+        recomputeStats();
     }
 
+    // Groups tiles into Config::chunkSize^2 chunks (tiles of a chunk become contiguous, soil follows)
+    void buildChunks() {
+        std::vector<sf::Vector2f> positions;
+        positions.reserve(tiles.size());
+        for (const auto &t : tiles) positions.push_back(t.position);
+
+        std::vector<int> order;
+        auto ranges = ChunkIndex::sortOrder(positions, tileSize, order);
+        ChunkIndex::permute(tiles, order);
+        soil.permute(order);
+
+        chunks.clear();
+        for (auto &range : ranges) {
+            LandChunk chunk;
+            chunk.range = range;
+            chunks.push_back(chunk);
+        }
+    }
+
+    void markDirty() {
+        for (auto &chunk : chunks) chunk.version++;
+    }
+
+    // Full rescan; used after bulk edits (planting, reset) and by the debug consistency check
+    void recomputeStats() { stats = LandStats::fromTiles(tiles); }
+
+    // Bulk edits from outside (planting a selection, reset) end with this
+    void tilesChanged() {
+        recomputeStats();
+        markDirty();
+    }
+
+    // Tile and soil storage, and per chunk the farmland quads and the LOD and overlay textures once
+    // drawn. Tile storage is only resized between SimThread::stop() and start(), so the render
+    // thread may call this while the simulation runs; the growth scratch is in scratchBytes().
+    void reportMemory(MemoryReport &report) const {
+        report.tiles += tiles.size();
+        report.add(TileStorage, "land tiles", MemoryReport::vectorBytes(tiles));
+        report.add(TileStorage, "soil factors", soil.capacity() * SoilStore::bytesPerTile());
+        report.add(TileStorage, "pond coverage", MemoryReport::vectorBytes(pondCoverage));
+        report.add(TileStorage, "land chunks", MemoryReport::vectorBytes(chunks));
+
+        std::size_t ground = 0, textures = 0, crops = 0;
+        for (const auto &chunk : chunks) {
+            ground += MemoryReport::vertexBytes(chunk.ground);
+            textures += MemoryReport::textureBytes(chunk.lodTexture) + MemoryReport::textureBytes(chunk.overlayTexture);
+            for (const auto &texture : chunk.soilTextures) textures += MemoryReport::textureBytes(texture);
+        }
+        for (const auto &batch : cropBatches) crops += MemoryReport::vertexBytes(batch);
+        report.add(RenderBuffers, "farmland quads", ground);
+        report.add(RenderBuffers, "crop quads", crops);
+        report.add(RenderBuffers, "chunk textures (GPU)", textures);
+    }
+
+    // Simulation thread only
+    std::size_t scratchBytes() const { return MemoryReport::vectorBytes(qualityScratch) + MemoryReport::vectorBytes(noiseScratch); }
+
+#ifndef NDEBUG
+    int stepsSinceVerify = 0;
+
+    void verifyStats() {
+        LandStats exact = LandStats::fromTiles(tiles);
+        if (!stats.matches(exact)) {
+            std::cerr << "LandStats drifted: growth " << stats.growthSum << " vs " << exact.growthSum << ", water " << stats.waterSum << " vs "
+                      << exact.waterSum << ", matured " << stats.maturedTiles << " vs " << exact.maturedTiles << "\n";
+        }
+        stats = exact;
+    }
+#endif
+
     void generateTiles(const std::vector<std::array<float, 9>> &soilMatrix) {
         tiles.clear();
+        soil.clear();
 
         if (soilMatrix.empty()) {
             std::cerr << "Soil matrix is empty! Cannot generate tiles.\n";
@@ -86,17 +258,21 @@ class Land {
         // Extract just positions for normalization
         std::vector<sf::Vector2f> positions;
         positions.reserve(soilMatrix.size());
+        tiles.reserve(soilMatrix.size());
+        soil.reserve(soilMatrix.size());
         for (auto &vals : soilMatrix) {
             positions.push_back({vals[0], vals[1]});
         }
 
-        Normalizer normalizer(positions);
+        // One grid cell per tile in world space; the camera handles fitting it on screen
+        Normalizer normalizer(positions, Config::landTileSize);
 
         int neighborRadius = 0;  // 1 → 3x3 = 9 tiles (center + 8 neighbors)
                                  // 2 → 5x5 = 25 tiles, etc.
 
         for (const auto &vals : soilMatrix) {
             sf::Vector2f base = normalizer.normalize({vals[0], vals[1]});
+            SoilSample sample{vals[2], vals[3], vals[4], vals[5], vals[6], vals[7], vals[8]};
             float tileSize = Config::landTileSize;
 
             // generate neighbors
@@ -105,225 +281,485 @@ class Land {
                     float px = base.x + dx * tileSize;
                     float py = base.y + dy * tileSize;
 
-                    // Skip anything inside UI reserved area (15% left side)
-                    if (px < (normalizer.screenW * 0.15f)) continue;
-
-                    // Keep inside screen
-                    if (px + tileSize > normalizer.screenW) continue;
-                    if (py < 0 || py + tileSize > normalizer.screenH) continue;
-
                     Tile t;
                     t.position = sf::Vector2f(px, py);
                     t.size = tileSize;
                     t.isInsideLand = true;
                     t.hasCrop = false;
-
-                    // Soil attributes
-                    t.soilBaseQuality = vals[2];
-                    t.sunlight = vals[3];
-                    t.nutrients = vals[4];
-                    t.pH = vals[5];
-                    t.organicMatter = vals[6];
-                    t.compaction = vals[7];
-                    t.salinity = vals[8];
                     t.waterLevel = 0.f;
 
                     tiles.push_back(t);
+                    soil.push_back(sample);
                 }
             }
         }
 
-        std::cout << "Generated " << tiles.size() << " land tiles (with neighbors).\n";
+        buildChunks();
+        recomputeStats();
+        std::cout << "Generated " << tiles.size() << " land tiles (with neighbors) in " << chunks.size() << " chunks.\n";
     }
 
-    float computeSoilQuality(const Tile &tile, const CropType &crop) {
-        float waterFactor = 1.f - std::abs(tile.waterLevel - crop.optimalWater) / crop.tolerance;
-        waterFactor = std::clamp(waterFactor, 0.f, 1.f);
+    static float waterFactor(float waterLevel, CropId crop) {
+        const CropRegistry &registry = CropRegistry::get();
+        if (!registry.valid(crop)) return 0.f;  // no crop, no water target
+        return std::clamp(1.f - std::abs(waterLevel - registry.optimalWater[crop]) / registry.tolerance[crop], 0.f, 1.f);
+    }
 
-        float quality = 0.f;
-        quality += 0.25f * tile.soilBaseQuality;
-        quality += 0.15f * tile.sunlight;
-        quality += 0.15f * tile.nutrients;
-        quality += 0.1f * tile.pH;
-        quality += 0.15f * tile.organicMatter;
-        quality += 0.1f * (1.f - tile.compaction);
-        quality += 0.1f * (1.f - tile.salinity);
-        quality += 0.1f * waterFactor;  // water now included in weighted sum
+    // Weighted soil factors of tiles[index] plus the water term for `crop`
+    float computeSoilQuality(int index, CropId crop) const { return computeSoilQuality(index, crop, tiles[index].waterLevel); }
 
-        return std::clamp(quality, 0.f, 1.f);
+    // Same for a given water level; reads only the static soil, so it is safe from the render thread
+    float computeSoilQuality(int index, CropId crop, float waterLevel) const {
+        return soilQuality(soil.staticQuality(index), waterFactor(waterLevel, crop));
     }
 
     // ---------------- Update Tile Water ----------------
-    void updateTileWater(Tile &tile, const std::vector<Pond> &ponds, float dt, const CropType &cropType) {
-        float targetWater = 0.f;
+    // `coverage` is the nearest pond's pull (pondCoverage): the tile approaches coverage * optimal water
+    static void updateTileWater(Tile &tile, float coverage, float dt, CropId cropId) {
+        float targetWater = coverage * CropRegistry::get().optimalWater[cropId];
 
-        for (const auto &pond : ponds) {
-            for (const auto &ptile : pond.tiles) {
-                // Compute center-to-center distance
-                float dx = (tile.position.x + tile.size / 2.f) - (ptile.getPosition().x + ptile.getSize().x / 2.f);
-                float dy = (tile.position.y + tile.size / 2.f) - (ptile.getPosition().y + ptile.getSize().y / 2.f);
-                float dist = std::sqrt(dx * dx + dy * dy);
+        // Smoothly approach target water level
+        tile.waterLevel += (targetWater - tile.waterLevel) * waterSpeed * dt;
 
-                // Water contribution decreases with distance (max distance = 5 * tile size)
-                float waterFactor = std::max(0.f, 1.f - dist / (ptile.getSize().x * 5.f));
+        // Evaporation
+        float evaporation = evaporationRate * dt;
+        tile.waterLevel = std::clamp(tile.waterLevel - evaporation, 0.f, 1.f);
+    }
 
-                // Take the maximum water factor among all pond tiles
-                targetWater = std::max(targetWater, waterFactor * cropType.optimalWater);
+    // One growth step of chunks [first, last), scratch buffers and stats deltas supplied by the caller
+    void growChunks(std::size_t first, std::size_t last, float dt, bool raining, float simTime, std::uint64_t step, std::uint64_t seed,
+                    float climate, std::vector<float> &quality, std::vector<float> &noise, LandStats &delta) {
+        const CounterRng rng(RngStream::GrowthNoise, seed);
+        const std::uint64_t rngBase = (std::uint64_t)rngId << 32;
+
+        for (std::size_t c = first; c < last; c++) {
+            LandChunk &chunk = chunks[c];
+            // Static soil part and variability for the whole chunk, each in one vectorized pass
+            std::size_t count = chunk.range.end - chunk.range.begin;
+            quality.resize(count);
+            noise.resize(count);
+            soil.staticQuality(chunk.range.begin, chunk.range.end, quality.data());
+            rng.uniformBatch(0.9f, 1.1f, rngBase + chunk.range.begin, step, noise.data(), count);  // small variability
+
+            // Runs of tiles with the same crop share one growth kernel, picked once per run
+            const CropRegistry &registry = CropRegistry::get();
+            const int base = chunk.range.begin;
+            bool touched = false;
+            for (int i = chunk.range.begin; i < chunk.range.end;) {
+                if (!tiles[i].hasCrop) {
+                    i++;
+                    continue;
+                }
+                int end = i + 1;
+                while (end < chunk.range.end && tiles[end].hasCrop && tiles[end].cropId == tiles[i].cropId) end++;
+                registry.withGrowthParams(tiles[i].cropId, [&](const auto &params) {
+                    for (int t = i; t < end; t++) growTile(t, quality[t - base], noise[t - base], dt, raining, simTime, climate, params, delta);
+                });
+                touched = true;
+                i = end;
             }
+            if (touched) chunk.version++;
         }
+    }
 
-        // Smoothly approach target water level
-        float waterSpeed = 0.5f;  // change rate per second
-        tile.waterLevel += (targetWater - tile.waterLevel) * waterSpeed * dt;
+    // One growth step of a planted tile, given its static soil quality, variability factor and its
+    // crop's growth parameters (see CropRegistry::withGrowthParams); the changes to the running stats
+    // go to `delta`. timeToMature counts from the tile's planting (Tile::plantedAt).
+    template <typename Params>
+    void growTile(int i, float staticQuality, float noise, float dt, bool raining, float simTime, float climate, const Params &params,
+                  LandStats &delta) {
+        Tile &tile = tiles[i];
+        float oldWater = tile.waterLevel, oldSoil = tile.soilQuality, oldGrowth = tile.crop.growth;
+
+        CropId cropId = tile.cropId;  // Use the actual crop planted in this tile
+
+        // ---------------- Rain ----------------
+        if (raining) {
+            tile.waterLevel += Config::rainIntensity * dt;
+            tile.waterLevel = std::clamp(tile.waterLevel, 0.f, 1.f);
+        }
 
-        // Evaporation
-        float evaporation = 0.01f * dt;
-        tile.waterLevel = std::max(tile.waterLevel - evaporation, 0.f);
+        // ---------------- Water from Ponds ----------------
+        updateTileWater(tile, pondCoverage[i], dt, cropId);
+
+        // ---------------- Soil Quality ----------------
+        tile.soilQuality = soilQuality(staticQuality, waterFactor(tile.waterLevel, cropId));
+
+        // ---------------- Growth (water stress included) ----------------
+        float growthRate = Harvestor::growthRate(params, tile.soilQuality, tile.waterLevel);
+        growthRate *= noise * climate;  // add variability
+
+        tile.crop.growth += growthRate * dt;
+        tile.crop.growth = std::clamp(tile.crop.growth, 0.f, 1.f);
+
+        // Record time of maturity
+        if (tile.crop.growth >= 1.f && tile.timeToMature < 0.f) {
+            tile.timeToMature = simTime - tile.plantedAt;
+        }
+
+        // ---------------- Running stats ----------------
+        delta.waterSum += tile.waterLevel - oldWater;
+        delta.soilSum += tile.soilQuality - oldSoil;
+        delta.growthSum += tile.crop.growth - oldGrowth;
+        if (oldGrowth < 1.f && tile.crop.growth >= 1.f) delta.maturedTiles++;
     }
 
-    void plantCrops(const CropType &cropType) {
-        for (auto &tile : tiles) {
+    void plantCrops(CropId cropId) {
+        float optimalWater = CropRegistry::get().optimalWater[cropId];
+        for (int i = 0; i < (int)tiles.size(); i++) {
+            Tile &tile = tiles[i];
             tile.hasCrop = true;
-            tile.cropType = cropType;  // <--- assign the crop type
+            tile.cropId = cropId;  // <--- assign the crop type
             tile.crop.growth = 0.f;
             tile.crop.originalSize = sf::Vector2f(tile.size, tile.size);
 
-            sf::Vector2f initialSize = tile.crop.originalSize * Config::cropInitialScale;
-            tile.crop.shape.setSize(initialSize);
-            tile.crop.shape.setPosition(tile.position.x + (tile.size - initialSize.x) / 2, tile.position.y + (tile.size - initialSize.y) / 2);
-            tile.crop.shape.setFillColor(cropType.baseColor);
-
             // INITIAL WATER: set close to crop optimal
-            tile.waterLevel = cropType.optimalWater;
+            tile.waterLevel = optimalWater;
 
             // Compute initial soil quality
-            tile.soilQuality = computeSoilQuality(tile, cropType);
+            tile.soilQuality = computeSoilQuality(i, cropId);
         }
+        tilesChanged();
     }
 
-    void updateGrowth(float dt, const std::vector<Pond> &ponds, bool simulate, bool raining, float simTime) {
-        if (!simulate) return;
+    // Plants crops[i] on tiles[i] at simulation time `plantedAt`; tiles mapped to kNoCrop are left as they are
+    void plantMap(const std::vector<CropId> &crops, float plantedAt = 0.f) {
+        const CropRegistry &registry = CropRegistry::get();
+        for (int i = 0; i < (int)tiles.size() && i < (int)crops.size(); i++) {
+            if (!registry.valid(crops[i])) continue;
+            Tile &tile = tiles[i];
+            tile.hasCrop = true;
+            tile.cropId = crops[i];
+            tile.crop.growth = 0.f;
+            tile.crop.originalSize = sf::Vector2f(tile.size, tile.size);
+            tile.waterLevel = registry.optimalWater[crops[i]];
+            tile.soilQuality = computeSoilQuality(i, crops[i]);
+            tile.plantedAt = plantedAt;
+            tile.timeToMature = -1.f;
+        }
+        tilesChanged();
+    }
 
-        static std::mt19937 rng(12345);                          // fixed seed for reproducibility
-        std::uniform_real_distribution<float> dist(0.9f, 1.1f);  // small variability
+    // Water of each tile in `chunk` += rain * factor[i - range.begin] - evaporation, clamped to 0..1
+    void applyWater(LandChunk &chunk, const float *factor, float rain, float evaporation) {
+        double delta = 0.0;
+        for (int i = chunk.range.begin; i < chunk.range.end; i++) {
+            float &water = tiles[i].waterLevel;
+            float old = water;
+            water = std::clamp(water + rain * factor[i - chunk.range.begin] - evaporation, 0.f, 1.f);
+            delta += water - old;
+        }
+        stats.waterSum += delta;
+        chunk.version++;
+    }
 
+    // Rain boost applied on top of the regular step (water and growth), with running stats
+    void applyRainBoost(float dt) {
         for (auto &tile : tiles) {
             if (!tile.hasCrop) continue;
+            float oldWater = tile.waterLevel, oldGrowth = tile.crop.growth;
 
-            const CropType &cropType = tile.cropType;  // Use the actual crop planted in this tile
+            tile.waterLevel += dt * 0.3f;
+            tile.waterLevel = std::clamp(tile.waterLevel, 0.f, 1.f);
 
-            // ---------------- Rain ----------------
-            if (raining) {
-                tile.waterLevel += Config::rainIntensity * dt;
-                tile.waterLevel = std::clamp(tile.waterLevel, 0.f, 1.f);
-            }
+            tile.crop.growth += dt * Config::rainGrowthBoost;
+            tile.crop.growth = std::clamp(tile.crop.growth, 0.f, 1.f);
 
-            // ---------------- Water from Ponds ----------------
-            float targetWater = 0.f;
-            for (const auto &pond : ponds) {
-                for (const auto &ptile : pond.tiles) {
-                    // Compute center-to-center distance between the land tile and pond tile
-                    float dx = (tile.position.x + tile.size / 2.f) - (ptile.getPosition().x + ptile.getSize().x / 2.f);
-                    float dy = (tile.position.y + tile.size / 2.f) - (ptile.getPosition().y + ptile.getSize().y / 2.f);
-                    float dist = std::sqrt(dx * dx + dy * dy);
+            stats.waterSum += tile.waterLevel - oldWater;
+            stats.growthSum += tile.crop.growth - oldGrowth;
+            if (oldGrowth < 1.f && tile.crop.growth >= 1.f) stats.maturedTiles++;
+        }
+        markDirty();
+    }
 
-                    // Water contribution decreases with distance (max distance = 5 * pond tile size)
-                    float waterFactor = std::max(0.f, 1.f - dist / (ptile.getSize().x * 5.f));
+    // `step` keys the growth variability: tile i of this land at a given step always draws the same factor.
+    // `climate` scales growth for weather (WeatherDriver::climateFactor).
+    // Chunks share nothing but the running stats, so lands of Config::parallelGrowthTiles tiles or
+    // more step their chunks on several threads; tile results do not depend on the split.
+    void updateGrowth(float dt, bool simulate, bool raining, float simTime, std::uint64_t step, std::uint64_t seed, float climate = 1.f) {
+        if (!simulate) return;
+        if (pondCoverage.size() != tiles.size()) pondCoverage.assign(tiles.size(), 0.f);  // never given a FarmGrid
+
+        if ((int)tiles.size() < Config::parallelGrowthTiles) {
+            growChunks(0, chunks.size(), dt, raining, simTime, step, seed, climate, qualityScratch, noiseScratch, stats);
+        } else {
+            std::mutex statsMutex;
+            parallelFor(
+                chunks.size(),
+                [&](std::size_t begin, std::size_t end) {
+                    std::vector<float> quality, noise;
+                    LandStats delta;
+                    growChunks(begin, end, dt, raining, simTime, step, seed, climate, quality, noise, delta);
+                    std::lock_guard<std::mutex> lock(statsMutex);
+                    stats += delta;
+                },
+                1);
+        }
 
-                    // Take the maximum contribution from all pond tiles
-                    targetWater = std::max(targetWater, waterFactor * cropType.optimalWater);
-                }
-            }
+#ifndef NDEBUG
+        if (++stepsSinceVerify >= Config::statsVerifySteps) {
+            verifyStats();
+            stepsSinceVerify = 0;
+        }
+#endif
+    }
 
-            // Smoothly approach target water level
-            float waterSpeed = 0.5f;  // rate per second
-            tile.waterLevel += (targetWater - tile.waterLevel) * waterSpeed * dt;
+    // The same step for `indices` (ascending) only, drawing the same soil and variability values as
+    // the whole-land step would; tiles outside are left as they are (see RegionRun)
+    void updateGrowth(const std::vector<int> &indices, float dt, bool raining, float simTime, std::uint64_t step, std::uint64_t seed,
+                      float climate = 1.f) {
+        if (pondCoverage.size() != tiles.size()) pondCoverage.assign(tiles.size(), 0.f);
+        const CounterRng rng(RngStream::GrowthNoise, seed);
+        const std::uint64_t rngBase = (std::uint64_t)rngId << 32;
+
+        auto chunk = chunks.begin();
+        for (int i : indices) {
+            if (!tiles[i].hasCrop) continue;
+            while (chunk->range.end <= i) ++chunk;
+            float quality, noise;
+            soil.staticQuality(i, i + 1, &quality);
+            rng.uniformBatch(0.9f, 1.1f, rngBase + i, step, &noise, 1);
+            CropRegistry::get().withGrowthParams(tiles[i].cropId, [&](const auto &params) {
+                growTile(i, quality, noise, dt, raining, simTime, climate, params, stats);
+            });
+            chunk->version++;
+        }
+    }
 
-            // Evaporation
-            float evaporation = 0.01f * dt;
-            tile.waterLevel = std::clamp(tile.waterLevel - evaporation, 0.f, 1.f);
+    float getCropGrowthPercentage() const { return stats.maturedPercentage(); }
 
-            // ---------------- Soil Quality ----------------
-            tile.soilQuality = computeSoilQuality(tile, cropType);
+    // ---------------- Crop visuals (derived from tile state) ----------------
+    static sf::Color cropColor(const Tile &tile) {
+        sf::Color color = CropRegistry::get().baseColor[tile.cropId];
 
-            // ---------------- Water Stress ----------------
-            float waterDiff = tile.waterLevel - cropType.optimalWater;
-            float waterStress = std::exp(-(waterDiff * waterDiff) / (2.f * cropType.tolerance * cropType.tolerance));
-            waterStress = std::clamp(waterStress, 0.f, 1.f);
+        // Darken fully grown crops slightly
+        if (tile.crop.growth >= 1.f) {
+            float darkFactor = 0.5f + 0.5f * (1.f - tile.crop.growth);
+            float h, s, l;
+            ColorUtils::RGBtoHSL(color, h, s, l);
+            l *= darkFactor;
+            color = ColorUtils::HSLtoRGB(h, s, l);
+        }
+        return color;
+    }
 
-            // ---------------- Growth ----------------
-            float growthRate = Config::growthSpeed * cropType.baseGrowthRate * tile.soilQuality * waterStress;
-            growthRate *= dist(rng);  // add variability
+    static CropBatch cropBatch(const Tile &tile) {
+        if (tile.crop.growth < 1.f) return PlainBatch;
+        switch (CropRegistry::get().matureSprite[tile.cropId]) {
+            case MatureSprite::Wheat:
+                return WheatBatch;
+            case MatureSprite::Tomato:
+                return TomatoBatch;
+            case MatureSprite::Sugarcane:
+                return SugarcaneBatch;
+            default:
+                return PlainBatch;
+        }
+    }
 
-            tile.crop.growth += growthRate * dt;
-            tile.crop.growth = std::clamp(tile.crop.growth, 0.f, 1.f);
+    static void appendQuad(sf::VertexArray &va, sf::Vector2f pos, sf::Vector2f size, sf::Color color, sf::Vector2f texSize) {
+        va.append(sf::Vertex(pos, color, sf::Vector2f(0.f, 0.f)));
+        va.append(sf::Vertex(sf::Vector2f(pos.x + size.x, pos.y), color, sf::Vector2f(texSize.x, 0.f)));
+        va.append(sf::Vertex(pos + size, color, texSize));
+        va.append(sf::Vertex(sf::Vector2f(pos.x, pos.y + size.y), color, sf::Vector2f(0.f, texSize.y)));
+    }
 
-            // Record time of maturity
-            if (tile.crop.growth >= 1.f && tile.timeToMature < 0.f) {
-                tile.timeToMature = simTime;
+    // ---------------- Snapshot ----------------
+    // Copies what draw() needs; called on the simulation thread. Reuses out's storage.
+    void snapshot(LandSnapshot &out) const {
+        out.tiles.resize(tiles.size());
+        for (std::size_t i = 0; i < tiles.size(); i++) {
+            const Tile &tile = tiles[i];
+            TileVisual &v = out.tiles[i];
+            v.growth = tile.crop.growth;
+            v.waterLevel = tile.waterLevel;
+            v.cropId = tile.cropId;
+            v.hasCrop = tile.hasCrop;
+            if (tile.hasCrop) {
+                v.color = cropColor(tile);
+                v.batch = (std::uint8_t)cropBatch(tile);
             }
+        }
+        out.chunkVersions.resize(chunks.size());
+        for (std::size_t c = 0; c < chunks.size(); c++) out.chunkVersions[c] = chunks[c].version;
+    }
 
-            // ---------------- Visual Scaling ----------------
-            sf::Vector2f size =
-                tile.crop.originalSize * (Config::cropInitialScale + (Config::cropMaxScale - Config::cropInitialScale) * tile.crop.growth);
-            tile.crop.shape.setSize(size);
-            tile.crop.shape.setPosition(tile.position.x + (tile.size - size.x) / 2, tile.position.y + (tile.size - size.y) / 2);
-
-            // ---------------- Color Adjustment ----------------
-            sf::Color targetColor = cropType.baseColor;
-
-            // Darken fully grown crops slightly
-            if (tile.crop.growth >= 1.f) {
-                float darkFactor = 0.5f + 0.5f * (1.f - tile.crop.growth);
-                float h, s, l;
-                ColorUtils::RGBtoHSL(targetColor, h, s, l);
-                l *= darkFactor;
-                targetColor = ColorUtils::HSLtoRGB(h, s, l);
-            }
+    // ---------------- LOD ----------------
+    // Zoomed-out summary texel: soil color by fertility, blended toward the crop color by growth
+    static sf::Color lodColor(const TileVisual &tile, float fertility) {
+        auto lerp = [](sf::Uint8 a, sf::Uint8 b, float t) { return (sf::Uint8)(a + (b - a) * std::clamp(t, 0.f, 1.f)); };
+        sf::Color poor(160, 130, 90), rich(80, 55, 30);
+        sf::Color ground(lerp(poor.r, rich.r, fertility), lerp(poor.g, rich.g, fertility), lerp(poor.b, rich.b, fertility));
+        if (!tile.hasCrop) return ground;
+
+        sf::Color crop = tile.color;
+        float t = 0.35f + 0.65f * tile.growth;
+        return sf::Color(lerp(ground.r, crop.r, t), lerp(ground.g, crop.g, t), lerp(ground.b, crop.b, t));
+    }
+
+    // Texel of tiles[i] in its chunk's Config::chunkSize^2 textures, -1 if it falls outside
+    int chunkTexel(const LandChunk &chunk, int i) const {
+        int n = Config::chunkSize;
+        sf::Vector2i cell = ChunkIndex::cellOf(tiles[i].position, tileSize);
+        int lx = cell.x - chunk.range.cell.x;
+        int ly = cell.y - chunk.range.cell.y;
+        if (lx < 0 || ly < 0 || lx >= n || ly >= n) return -1;
+        return ly * n + lx;
+    }
 
-            tile.crop.shape.setFillColor(targetColor);
+    // Fills a chunk texture from texel(i, px) per tile; transparent where there is no tile
+    template <typename TexelFn>
+    void bakeTexture(const LandChunk &chunk, sf::Texture &texture, bool smooth, TexelFn &&texel) {
+        unsigned n = (unsigned)Config::chunkSize;
+        if (texture.getSize().x != n) {
+            texture.create(n, n);
+            texture.setSmooth(smooth);
         }
+
+        std::vector<sf::Uint8> pixels(n * n * 4, 0);
+        for (int i = chunk.range.begin; i < chunk.range.end; i++) {
+            int t = chunkTexel(chunk, i);
+            if (t >= 0) texel(i, &pixels[t * 4]);
+        }
+        texture.update(pixels.data());
     }
 
-    float getCropGrowthPercentage() const {
-        int total = 0, grown = 0;
-        for (auto &tile : tiles)
-            if (tile.hasCrop) {
-                total++;
-                if (tile.crop.growth >= 1.f) grown++;
-            }
-        if (total == 0) return 0.f;
-        return (float)grown / total * 100.f;
+    void bakeChunk(LandChunk &chunk, const LandSnapshot &snap, std::uint32_t version) {
+        bakeTexture(chunk, chunk.lodTexture, true, [&](int i, sf::Uint8 *px) {
+            sf::Color c = lodColor(snap.tiles[i], soil.get(i, SoilBase));
+            px[0] = c.r;
+            px[1] = c.g;
+            px[2] = c.b;
+            px[3] = 255;
+        });
+        chunk.bakedVersion = version;
     }
 
-    void draw(sf::RenderWindow &window, const CropType &cropType) {
-        // window.draw(shape);
-        for (auto &tile : tiles) {
-            // std::cout << tile.position.x << " " << tile.position.y << std::endl;
-            sf::RectangleShape rect(sf::Vector2f(tile.size, tile.size));
-            rect.setPosition(tile.position);
+    // Overlay attributes: dynamic ones from the snapshot, static soil factors once
+    void bakeOverlay(LandChunk &chunk, const LandSnapshot &snap, std::uint32_t version) {
+        auto unit = [](float v) { return (sf::Uint8)std::lround(std::clamp(v, 0.f, 1.f) * 255.f); };
+        bakeTexture(chunk, chunk.overlayTexture, false, [&](int i, sf::Uint8 *px) {
+            const TileVisual &v = snap.tiles[i];
+            px[0] = unit(v.waterLevel);
+            px[1] = unit(v.growth);
+            px[2] = unit(computeSoilQuality(i, v.cropId, v.waterLevel));
+            px[3] = v.hasCrop ? 255 : 128;
+        });
+        chunk.overlayVersion = version;
+
+        if (chunk.soilTextures[0].getSize().x != 0) return;
+        bakeTexture(chunk, chunk.soilTextures[0], false, [&](int i, sf::Uint8 *px) {
+            px[0] = unit(soil.get(i, SoilBase));
+            px[1] = unit(soil.get(i, Sunlight));
+            px[2] = unit(soil.get(i, Nutrients));
+            px[3] = unit(soil.get(i, PH));
+        });
+        bakeTexture(chunk, chunk.soilTextures[1], false, [&](int i, sf::Uint8 *px) {
+            px[0] = unit(soil.get(i, OrganicMatter));
+            px[1] = unit(soil.get(i, Compaction));
+            px[2] = unit(soil.get(i, Salinity));
+            px[3] = 255;
+        });
+    }
 
-            rect.setTexture(&farmlandTexture);
-            rect.setTextureRect(sf::IntRect(0, 0, static_cast<int>(tile.size), static_cast<int>(tile.size)));
+    // Heatmap of the visible chunks, one shaded sprite each; attribute textures of changed chunks
+    // are re-uploaded at most every Config::lodRebakeInterval, like the LOD textures
+    void drawOverlay(sf::RenderTarget &target, const sf::FloatRect &visible, const LandSnapshot &snap, HeatmapOverlay &overlay, sf::Shader &shader) {
+        if (snap.tiles.size() != tiles.size() || snap.chunkVersions.size() != chunks.size()) return;  // stale layout
+        bool rebakeDue = overlayClock.getElapsedTime().asSeconds() >= Config::lodRebakeInterval;
+        bool baked = false;
+
+        for (std::size_t c = 0; c < chunks.size(); c++) {
+            LandChunk &chunk = chunks[c];
+            if (!visible.intersects(chunk.range.bounds)) continue;
+
+            std::uint32_t version = snap.chunkVersions[c];
+            if (chunk.overlayTexture.getSize().x == 0 || (chunk.overlayVersion != version && rebakeDue)) {
+                bakeOverlay(chunk, snap, version);
+                baked = true;
+            }
+            overlay.bindSoil(chunk.soilTextures[0], chunk.soilTextures[1]);
+            sf::Sprite sprite(chunk.overlayTexture);
+            sprite.setPosition(chunk.range.bounds.left, chunk.range.bounds.top);
+            sprite.setScale(tileSize, tileSize);
+            target.draw(sprite, sf::RenderStates(&shader));
+        }
+        if (baked) overlayClock.restart();
+    }
 
-            window.draw(rect);
-            if (tile.hasCrop) {
-                window.draw(tile.crop.shape);
+    // Draws only chunks intersecting `visible`, from the latest simulation snapshot. Far away (tiles
+    // smaller than Config::lodTilePixels on screen) each chunk is a single baked sprite; close up
+    // tiles are batched per texture. Reads tile geometry and soil, which do not change while the
+    // simulation runs.
+    void draw(sf::RenderTarget &target, const sf::FloatRect &visible, float pixelsPerUnit, const LandSnapshot &snap) {
+        loadTextures();
+        bool lod = tileSize * pixelsPerUnit < Config::lodTilePixels;
+        bool rebakeDue = lodClock.getElapsedTime().asSeconds() >= Config::lodRebakeInterval;
+        bool baked = false;
+        bool current = snap.tiles.size() == tiles.size() && snap.chunkVersions.size() == chunks.size();  // not a stale layout
+
+        for (auto &batch : cropBatches) batch.clear();
+
+        for (std::size_t c = 0; c < chunks.size(); c++) {
+            LandChunk &chunk = chunks[c];
+            if (!visible.intersects(chunk.range.bounds)) continue;
+
+            if (lod && current) {
+                chunk.ground.clear();  // close-up geometry is rebuilt on demand
+                std::uint32_t version = snap.chunkVersions[c];
+                if (chunk.lodTexture.getSize().x == 0 || (chunk.bakedVersion != version && rebakeDue)) {
+                    bakeChunk(chunk, snap, version);
+                    baked = true;
+                }
+                sf::Sprite sprite(chunk.lodTexture);
+                sprite.setPosition(chunk.range.bounds.left, chunk.range.bounds.top);
+                sprite.setScale(tileSize, tileSize);
+                target.draw(sprite);
+                continue;
             }
-            if (tile.crop.growth >= 1.f) {
-                if (tile.cropType.name == "Barley")
-                    tile.crop.shape.setTexture(&wheatTexture);
-                else if (tile.cropType.name == "Tomato")
-                    tile.crop.shape.setTexture(&tomatoTexture);
-                else if (tile.cropType.name == "Sugarcane")
-                    tile.crop.shape.setTexture(&sugarcaneTexture);
+
+            const sf::Texture *ground = ResourceCache::get().texture(farmlandTexture);
+            if (ground && chunk.ground.getVertexCount() == 0) {
+                for (int i = chunk.range.begin; i < chunk.range.end; i++) {
+                    appendQuad(chunk.ground, tiles[i].position, sf::Vector2f(tiles[i].size, tiles[i].size), sf::Color::White,
+                               sf::Vector2f(tiles[i].size, tiles[i].size));
+                }
+            }
+            if (ground) target.draw(chunk.ground, sf::RenderStates(ground));  // grass shows through until it is uploaded
+            if (!current) continue;
+
+            for (int i = chunk.range.begin; i < chunk.range.end; i++) {
+                const TileVisual &visual = snap.tiles[i];
+                if (!visual.hasCrop) continue;
+
+                float tileSide = tiles[i].size;
+                float side = tileSide * (Config::cropInitialScale + (Config::cropMaxScale - Config::cropInitialScale) * visual.growth);
+                sf::Vector2f pos(tiles[i].position.x + (tileSide - side) / 2, tiles[i].position.y + (tileSide - side) / 2);
+
+                CropBatch batch = (CropBatch)visual.batch;
+                const sf::Texture *tex = batchTexture(batch);
+                sf::Vector2f texSize = tex ? sf::Vector2f(tex->getSize()) : sf::Vector2f(0.f, 0.f);
+                appendQuad(cropBatches[batch], pos, sf::Vector2f(side, side), visual.color, texSize);
             }
         }
+
+        if (baked) lodClock.restart();
+
+        for (int b = 0; b < NumCropBatches; b++) {
+            if (cropBatches[b].getVertexCount() == 0) continue;
+            target.draw(cropBatches[b], sf::RenderStates(batchTexture((CropBatch)b)));
+        }
+    }
+
+    // nullptr for plain crops and while the sprite is still loading
+    static const sf::Texture *batchTexture(CropBatch batch) {
+        ResourceCache &cache = ResourceCache::get();
+        static const std::array<TextureHandle, NumCropBatches> handles = {TextureHandle(), cache.request(Config::wheatTexturePath),
+                                                                          cache.request(Config::tomatoTexturePath),
+                                                                          cache.request(Config::sugarcaneTexturePath)};
+        return cache.texture(handles[batch]);
     }
 };
-sf::Texture Land::wheatTexture;
-sf::Texture Land::sugarcaneTexture;
-sf::Texture Land::tomatoTexture;
 
 }  // namespace Harvestor
 
@@ -0,0 +1,214 @@
+#ifndef LAYOUT_HPP_
+#define LAYOUT_HPP_
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "parallel.hpp"
+#include "region.hpp"
+
+namespace Harvestor {
+// ---------------- LayoutShape ----------------
+struct LayoutShape {
+    enum Kind { Land, Pond };
+    Kind kind;
+    sf::Vector2f centre;  // layout units
+    float radius;
+};
+
+// ---------------- FarmLayout ----------------
+// A layouts/*.txt file: `Land x y radius` and `Pond x y radius` lines in layout units, keywords in
+// any case, `#` starting a comment. Lands are circles (as in QualityMatrix), ponds irregular blobs
+// (BlobGenerator), so water edges look natural while field edges stay clean.
+class FarmLayout {
+   public:
+    std::vector<LayoutShape> shapes;
+
+    // Reads the whole file in one go and scans it with strtof; false if it cannot be read or holds no shape
+    static bool parse(const std::string &path, FarmLayout &layout) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open layout file: " << path << "\n";
+            return false;
+        }
+        std::ostringstream buffer;
+        buffer << file.rdbuf();
+        const std::string text = buffer.str();
+
+        layout.shapes.clear();
+        int lineNo = 0;
+        for (std::size_t pos = 0; pos < text.size();) {
+            std::size_t end = text.find('\n', pos);
+            if (end == std::string::npos) end = text.size();
+            lineNo++;
+            parseLine(text.data() + pos, text.data() + end, layout, path, lineNo);
+            pos = end + 1;
+        }
+        if (layout.shapes.empty()) {
+            std::cerr << "No Land or Pond in layout file: " << path << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Outline of `shape` in cell units (`cellsPerUnit` cells per layout unit)
+    static Region region(const LayoutShape &shape, float cellsPerUnit) {
+        if (shape.kind == LayoutShape::Land) return Region::circle(shape.centre * cellsPerUnit, shape.radius * cellsPerUnit);
+        sf::ConvexShape blob = BlobGenerator::generate(shape.centre.x, shape.centre.y, shape.radius);
+        std::vector<sf::Vector2f> points(blob.getPointCount());
+        for (std::size_t i = 0; i < points.size(); i++) points[i] = blob.getPoint(i) * cellsPerUnit;
+        return Region::polygon(std::move(points));
+    }
+
+   private:
+    static void parseLine(const char *p, const char *end, FarmLayout &layout, const std::string &path, int lineNo) {
+        auto skipSpace = [&]() {
+            while (p < end && std::isspace((unsigned char)*p)) p++;
+        };
+        skipSpace();
+        if (p == end || *p == '#') return;
+
+        const char *word = p;
+        while (p < end && std::isalpha((unsigned char)*p)) p++;
+        std::string keyword(word, p);
+        for (auto &c : keyword) c = (char)std::tolower((unsigned char)c);
+
+        LayoutShape shape;
+        if (keyword == "land")
+            shape.kind = LayoutShape::Land;
+        else if (keyword == "pond")
+            shape.kind = LayoutShape::Pond;
+        else {
+            std::cerr << path << ":" << lineNo << ": unknown layout primitive '" << keyword << "'\n";
+            return;
+        }
+
+        // strtof stops at the newline, so a short line cannot run into the next one
+        float values[3];
+        for (float &v : values) {
+            skipSpace();
+            char *next = nullptr;
+            v = p < end ? std::strtof(p, &next) : 0.f;
+            if (p == end || next == p || next > end) {
+                std::cerr << path << ":" << lineNo << ": expected " << keyword << " x y radius\n";
+                return;
+            }
+            p = next;
+        }
+        shape.centre = {values[0], values[1]};
+        shape.radius = values[2];
+        if (shape.radius > 0.f) layout.shapes.push_back(shape);
+    }
+};
+
+// ---------------- LayoutRaster ----------------
+// A FarmLayout on the cell grid: the fraction of every cell covered by land and by water, found
+// by scanning each cell row at Config::layoutSubsamples heights and adding up the exact lengths of
+// the covered intervals. Overlapping shapes of a kind are merged per scanline first, so coverage
+// is that of their union. Rows are independent and run in parallel; coverage is kept in 1/255
+// steps, a byte per cell and layer, so a layout of 10^8 cells rasterizes in 200 MB.
+class LayoutRaster {
+   public:
+    sf::Vector2i origin;  // cell of index 0
+    int width = 0, height = 0;
+    std::vector<std::uint8_t> landCoverage;   // 0..255 per cell, row-major
+    std::vector<std::uint8_t> waterCoverage;  // 0..255 per cell
+
+    // Water wins where a pond overlaps a land; a cell counts once its coverage reaches Config::layoutMinCoverage
+    bool isWater(std::size_t i) const { return waterCoverage[i] >= threshold(); }
+    bool isLand(std::size_t i) const { return !isWater(i) && landCoverage[i] >= threshold(); }
+
+    void build(const FarmLayout &layout, float cellsPerUnit = Config::layoutCellsPerUnit, int subsamples = Config::layoutSubsamples) {
+        std::vector<Region> lands, ponds;
+        sf::FloatRect bounds;
+        bool first = true;
+        for (const auto &shape : layout.shapes) {
+            Region region = FarmLayout::region(shape, cellsPerUnit);
+            sf::FloatRect b = region.bounds();
+            if (first) {
+                bounds = b;
+                first = false;
+            } else {
+                float right = std::max(bounds.left + bounds.width, b.left + b.width), bottom = std::max(bounds.top + bounds.height, b.top + b.height);
+                bounds.left = std::min(bounds.left, b.left);
+                bounds.top = std::min(bounds.top, b.top);
+                bounds.width = right - bounds.left;
+                bounds.height = bottom - bounds.top;
+            }
+            (shape.kind == LayoutShape::Land ? lands : ponds).push_back(std::move(region));
+        }
+
+        origin = sf::Vector2i((int)std::floor(bounds.left), (int)std::floor(bounds.top));
+        width = first ? 0 : (int)std::ceil(bounds.left + bounds.width) - origin.x;
+        height = first ? 0 : (int)std::ceil(bounds.top + bounds.height) - origin.y;
+        landCoverage.assign((std::size_t)width * height, 0);
+        waterCoverage.assign((std::size_t)width * height, 0);
+
+        parallelFor(
+            height,
+            [&](std::size_t begin, std::size_t end) {
+                std::vector<float> row(width), scratch;
+                std::vector<std::pair<float, float>> merged;
+                for (std::size_t y = begin; y < end; y++) {
+                    coverRow(lands, (int)y, subsamples, row, scratch, merged, landCoverage.data() + y * width);
+                    coverRow(ponds, (int)y, subsamples, row, scratch, merged, waterCoverage.data() + y * width);
+                }
+            },
+            16);
+    }
+
+   private:
+    static std::uint8_t threshold() { return (std::uint8_t)std::lround(std::clamp(Config::layoutMinCoverage, 0.f, 1.f) * 255.f); }
+
+    // Coverage of row `y` by the union of `regions`, summed in `row` (one float per cell) and stored to `coverage`
+    void coverRow(const std::vector<Region> &regions, int y, int subsamples, std::vector<float> &row, std::vector<float> &scratch,
+                  std::vector<std::pair<float, float>> &merged, std::uint8_t *coverage) const {
+        if (regions.empty()) return;
+        std::fill(row.begin(), row.end(), 0.f);
+        float *out = row.data();
+        int touched0 = width, touched1 = 0;  // cells written
+        const float weight = 1.f / subsamples;
+        for (int s = 0; s < subsamples; s++) {
+            float sy = origin.y + y + (s + 0.5f) * weight;
+            scratch.clear();
+            for (const auto &region : regions) region.intervals(sy, scratch);
+            if (scratch.empty()) continue;
+
+            // Union of the intervals
+            merged.clear();
+            for (std::size_t k = 0; k + 1 < scratch.size(); k += 2) merged.emplace_back(scratch[k] - origin.x, scratch[k + 1] - origin.x);
+            std::sort(merged.begin(), merged.end());
+            std::size_t n = 0;
+            for (std::size_t k = 1; k < merged.size(); k++) {
+                if (merged[k].first <= merged[n].second)
+                    merged[n].second = std::max(merged[n].second, merged[k].second);
+                else
+                    merged[++n] = merged[k];
+            }
+            merged.resize(n + 1);
+
+            // Exact covered length per cell: partial cells at both ends, whole ones in between
+            for (auto [a, b] : merged) {
+                a = std::max(a, 0.f);
+                b = std::min(b, (float)width);
+                if (b <= a) continue;
+                int x0 = (int)a, x1 = std::min((int)std::ceil(b), width) - 1;
+                touched0 = std::min(touched0, x0);
+                touched1 = std::max(touched1, x1 + 1);
+                if (x0 == x1) {
+                    out[x0] += (b - a) * weight;
+                    continue;
+                }
+                out[x0] += (x0 + 1 - a) * weight;
+                for (int x = x0 + 1; x < x1; x++) out[x] += weight;
+                out[x1] += (b - x1) * weight;
+            }
+        }
+        for (int x = touched0; x < touched1; x++) coverage[x] = (std::uint8_t)std::lround(std::min(out[x], 1.f) * 255.f);
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
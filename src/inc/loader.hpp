@@ -2,8 +2,10 @@
 #define LOADER_HPP_
 
 #include "QualityMatrix.hpp"
+#include "arena.hpp"
 #include "common.hpp"
 #include "land.hpp"
+#include "layout.hpp"
 
 namespace Harvestor {
 #include <algorithm>
@@ -117,120 +119,78 @@ class FarmLoader {
         return result;
     }
 
-    static void loadFromFile(const std::string &filename, std::vector<Land> &lands, std::vector<Pond> &ponds, const std::vector<CropType> &crops,
-                             int selectedCropIndex) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open " << filename << "\n";
-            return;
-        }
-
+    // One land from a soil CSV (x,y and the seven soil factors per row) and one pond from a CSV of
+    // x,y water cells, built in place like loadFromFile
+    static void loadFromCsv(const std::string &landFile, const std::string &waterFile, std::vector<Land> &lands, std::vector<Pond> &ponds,
+                            CropId selectedCrop, std::pmr::memory_resource *memory = std::pmr::get_default_resource()) {
         lands.clear();
         ponds.clear();
+        lands.reserve(1);  // Land is copied, not moved, on reallocation
+        ponds.reserve(1);
 
-        auto soilMatrix = SoilLoader::loadFromFile("input/land.csv");
-        Land land(Config::landTileSize);
+        auto soilMatrix = SoilLoader::loadFromFile(landFile);
+        Land &land = lands.emplace_back(Config::landTileSize, memory);
+        land.rngId = (std::uint32_t)(lands.size() - 1);
         land.generateTiles(soilMatrix);
 
-        lands.push_back(land);
-
         for (auto &land : lands) {
-            if (selectedCropIndex >= 0 && selectedCropIndex < crops.size()) {
-                land.plantCrops(crops[selectedCropIndex]);
+            if (CropRegistry::get().valid(selectedCrop)) {
+                land.plantCrops(selectedCrop);
             }
         }
 
-        Pond pond(Config::landTileSize);
-        auto points = parseCSV("input/water.csv");
+        Pond &pond = ponds.emplace_back(Config::landTileSize, memory);
+        auto points = parseCSV(waterFile);
         std::cout << "points " << points.size() << std::endl;
         pond.generate(points);
-
-        ponds.emplace_back(pond);
-
-        // struct TempLandData {
-        //     float cx, cy, r;
-        // };
-        // std::vector<TempLandData> tempLands;
-
-        // std::string type;
-        // while (file >> type) {
-        //     if (type[0] == '#') {
-        //         std::getline(file, type);
-        //         continue;
-        //     }
-
-        //     if (type == "Land") {
-        //         float cx, cy, r;
-        //         file >> cx >> cy >> r;
-        //         tempLands.push_back({cx, cy, r});
-        //     } else if (type == "Pond") {
-        //         float cx, cy, r;
-        //         file >> cx >> cy >> r;
-        //         ponds.emplace_back(cx, cy, r, 0.9f, 0.9f);
-        //     }
-        // }
-
-        // // ---------------- Generate combined soil matrix ----------------
-        // std::vector<Tile> allTiles;
-
-        // for (auto &l : tempLands) {
-        //     // QualityMatrix matrix(l.cx, l.cy, l.r, Config::landTileSize);
-        //     auto soilMatrix = SoilLoader::loadFromFile("input/soil_data.csv");
-        //     // auto tiles = matrix.generateTiles();
-
-        //     Land land(Config::landTileSize);
-        //     land.generateTiles(soilMatrix);
-
-        //     if (selectedCropIndex >= 0 && selectedCropIndex < crops.size()) {
-        //         land.plantCrops(crops[selectedCropIndex]);
-        //     }
-
-        //     lands.push_back(land);
-
-        //     allTiles.insert(allTiles.end(), tiles.begin(), tiles.end());
-        // }
-
-        // // Save the combined soil data to CSV
-        // std::ofstream soilFile(Config::soilDataFile);
-        // if (!soilFile.is_open()) {
-        //     std::cerr << "Error: Could not open soil_data.csv for writing\n";
-        // } else {
-        //     soilFile << "x,y,soilBaseQuality,sunlight,nutrients,pH,organicMatter,compaction,salinity\n";
-        //     for (auto &tile : allTiles) {
-        //         soilFile << tile.position.x << "," << tile.position.y << "," << tile.soilBaseQuality << "," << tile.sunlight << "," <<
-        //         tile.nutrients
-        //                  << "," << tile.pH << "," << tile.organicMatter << "," << tile.compaction << "," << tile.salinity << "\n";
-        //     }
-        // }
     }
-};
 
-class CropLoader {
-   public:
-    static std::vector<CropType> loadFromFile(const std::string &filename) {
-        std::vector<CropType> crops;
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open crop file: " << filename << "\n";
-            return crops;
-        }
-
-        std::string line;
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;  // skip comments
-            std::istringstream iss(line);
-            CropType crop;
-            int r, g, b;
-            if (iss >> crop.name >> crop.baseGrowthRate >> r >> g >> b >> crop.optimalWater >> crop.tolerance) {
-                crop.baseColor = sf::Color(r, g, b);
-                crops.push_back(crop);
-            } else {
-                std::cerr << "Invalid crop line: " << line << "\n";
+    // A layouts/*.txt file rasterized onto the tile grid (see LayoutRaster): every cell mostly covered
+    // by a Land becomes a tile of one land with generated soil (SoilNoise), every cell mostly covered
+    // by a Pond a water tile. Lands and ponds are built in place, their tile storage allocated from `memory`
+    // (the layout's LayoutArena), which must outlive them
+    static void loadFromFile(const std::string &filename, std::vector<Land> &lands, std::vector<Pond> &ponds, CropId selectedCrop,
+                             std::pmr::memory_resource *memory = std::pmr::get_default_resource()) {
+        lands.clear();
+        ponds.clear();
+        auto start = std::chrono::steady_clock::now();
+        FarmLayout layout;
+        if (!FarmLayout::parse(filename, layout)) return;
+        LayoutRaster raster;
+        raster.build(layout);
+
+        lands.reserve(1);  // Land is copied, not moved, on reallocation
+        ponds.reserve(1);
+        std::vector<Tile> tiles;
+        std::vector<sf::Vector2f> water;
+        const float ts = Config::landTileSize;
+        for (int y = 0; y < raster.height; y++) {
+            for (int x = 0; x < raster.width; x++) {
+                std::size_t i = (std::size_t)y * raster.width + x;
+                int cx = raster.origin.x + x, cy = raster.origin.y + y;
+                if (raster.isWater(i)) {
+                    water.emplace_back(cx * ts, cy * ts);
+                } else if (raster.isLand(i)) {
+                    Tile t;
+                    t.position = sf::Vector2f(cx * ts, cy * ts);
+                    tiles.push_back(t);
+                }
             }
         }
-        return crops;
+
+        Land &land = lands.emplace_back(ts, memory);
+        land.rngId = 0;
+        land.generateTiles(std::move(tiles), {});
+        SoilNoise().fill(land.tiles, ts, land.soil);
+        if (CropRegistry::get().valid(selectedCrop)) land.plantCrops(selectedCrop);
+        ponds.emplace_back(ts, memory).addTiles(water);
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Layout " << filename << ": " << layout.shapes.size() << " shapes, " << raster.width << "x" << raster.height << " cells, "
+                  << land.tiles.size() << " land and " << water.size() << " water tiles in " << ms << " ms\n";
     }
 };
+
 }  // namespace Harvestor
 
 #endif
\ No newline at end of file
@@ -0,0 +1,151 @@
+#ifndef MAP_EXPORT_HPP_
+#define MAP_EXPORT_HPP_
+
+#include <atomic>
+#include <chrono>
+
+#include "farmGrid.hpp"
+#include "parallel.hpp"
+
+namespace Harvestor {
+// ---------------- MapLayer ----------------
+enum class MapLayer { Growth = 0, Crops, Soil, Water, NumLayers };
+
+inline const char *mapLayerName(MapLayer layer) {
+    static const char *names[] = {"growth", "crops", "soil", "water"};
+    return names[(int)layer];
+}
+
+struct MapExportStats {
+    int tiles = 0;          // PNG files written
+    int columns = 0, rows = 0;
+    int width = 0, height = 0;  // whole mosaic, pixels
+    std::size_t bufferBytes = 0;  // pixel memory held per worker thread
+    double seconds = 0.0;
+};
+
+// ---------------- MapExporter ----------------
+// Renders the farm's tile state to PNG files without a window or GPU: a CPU rasterizer straight
+// from the tile arrays, through the FarmGrid (one grid cell = Config::exportCellPixels^2 pixels).
+// The image is cut into a mosaic of tilePixels x tilePixels PNGs, rendered and written in
+// parallel, each worker reusing one tile buffer, so memory stays bounded however large the
+// mosaic (and it may be larger than any GPU texture). Each layer also gets <layer>.txt describing
+// the mosaic. Lands must not change while it runs.
+class MapExporter {
+   public:
+    MapExporter(const std::vector<Land> &lands, const FarmGrid &grid, int cellPixels = Config::exportCellPixels, int tilePixels = Config::exportTilePixels)
+        : lands(lands), grid(grid), cellPixels(std::max(1, cellPixels)), tilePixels(std::max(1, tilePixels)) {}
+
+    // Writes dir/<layer>_<row>_<column>.png for every tile of the mosaic
+    MapExportStats write(const std::string &dir, MapLayer layer) const {
+        MapExportStats stats;
+        stats.width = grid.width * cellPixels;
+        stats.height = grid.height * cellPixels;
+        stats.columns = (stats.width + tilePixels - 1) / tilePixels;
+        stats.rows = (stats.height + tilePixels - 1) / tilePixels;
+        stats.bufferBytes = (std::size_t)tilePixels * tilePixels * 4 * 2;  // our buffer plus sf::Image's copy
+        if (stats.width == 0 || stats.height == 0) return stats;
+
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        std::string base = (std::filesystem::path(dir) / mapLayerName(layer)).string();
+
+        auto start = std::chrono::steady_clock::now();
+        std::atomic<int> written{0};
+        parallelFor(
+            (std::size_t)stats.columns * stats.rows,
+            [&](std::size_t begin, std::size_t end) {
+                std::vector<sf::Uint8> pixels;
+                std::vector<sf::Color> cells;
+                for (std::size_t t = begin; t < end; t++) {
+                    int row = (int)(t / stats.columns), column = (int)(t % stats.columns);
+                    int x0 = column * tilePixels, y0 = row * tilePixels;
+                    int w = std::min(tilePixels, stats.width - x0), h = std::min(tilePixels, stats.height - y0);
+                    renderTile(layer, x0, y0, w, h, pixels, cells);
+
+                    sf::Image image;
+                    image.create((unsigned)w, (unsigned)h, pixels.data());
+                    std::string path = base + "_" + std::to_string(row) + "_" + std::to_string(column) + ".png";
+                    if (image.saveToFile(path))
+                        written++;
+                    else
+                        std::cerr << "Failed to write " << path << "\n";
+                }
+            },
+            1);
+        stats.tiles = written;
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream manifest(base + ".txt");
+        manifest << "layer " << mapLayerName(layer) << "\ncolumns " << stats.columns << "\nrows " << stats.rows << "\ntilePixels " << tilePixels
+                 << "\nwidth " << stats.width << "\nheight " << stats.height << "\ncellPixels " << cellPixels << "\norigin " << grid.origin.x << " "
+                 << grid.origin.y << "\n";
+        return stats;
+    }
+
+    // Color of one grid cell; transparent outside the farm
+    sf::Color cellColor(MapLayer layer, int i) const {
+        if (!grid.isLand(i)) return grid.waterMask[i] ? pondColor : sf::Color::Transparent;
+        const Tile &tile = lands[grid.landMask[i]].tiles[grid.tileIndex[i]];
+        switch (layer) {
+            case MapLayer::Growth:
+                return tile.hasCrop ? ramp(tile.crop.growth, {sf::Color(120, 90, 60), sf::Color(220, 200, 60), sf::Color(40, 160, 40)}) : groundColor;
+            case MapLayer::Crops:
+                return tile.hasCrop ? Land::cropColor(tile) : groundColor;
+            case MapLayer::Soil:
+                return ramp(grid.staticQuality[i] / (1.f - SoilWeights::water), {sf::Color(190, 50, 40), sf::Color(230, 200, 60), sf::Color(40, 150, 60)});
+            case MapLayer::Water:
+                return ramp(tile.waterLevel, {sf::Color(235, 225, 200), sf::Color(120, 180, 230), sf::Color(20, 60, 170)});
+            default:
+                return groundColor;
+        }
+    }
+
+    // Three-stop linear colormap over 0..1
+    static sf::Color ramp(float t, const std::array<sf::Color, 3> &stops) {
+        t = std::clamp(t, 0.f, 1.f) * 2.f;
+        const sf::Color &a = stops[t < 1.f ? 0 : 1], &b = stops[t < 1.f ? 1 : 2];
+        float f = t < 1.f ? t : t - 1.f;
+        auto mix = [f](sf::Uint8 x, sf::Uint8 y) { return (sf::Uint8)std::lround(x + (y - x) * f); };
+        return sf::Color(mix(a.r, b.r), mix(a.g, b.g), mix(a.b, b.b));
+    }
+
+   private:
+    const std::vector<Land> &lands;
+    const FarmGrid &grid;
+    int cellPixels, tilePixels;
+
+    static inline const sf::Color pondColor{60, 160, 210};
+    static inline const sf::Color groundColor{139, 105, 70};
+
+    // RGBA pixels of mosaic region [x0, x0 + w) x [y0, y0 + h): each grid row's colors are computed
+    // once, expanded to one pixel row, and that row repeated cellPixels times
+    void renderTile(MapLayer layer, int x0, int y0, int w, int h, std::vector<sf::Uint8> &pixels, std::vector<sf::Color> &cells) const {
+        pixels.resize((std::size_t)w * h * 4);
+        int cx0 = x0 / cellPixels, cx1 = (x0 + w - 1) / cellPixels;
+        cells.resize(cx1 - cx0 + 1);
+
+        int cachedRow = -1;
+        for (int y = 0; y < h; y++) {
+            sf::Uint8 *out = pixels.data() + (std::size_t)y * w * 4;
+            int cy = (y0 + y) / cellPixels;
+            if (cy == cachedRow) {
+                std::copy(out - (std::size_t)w * 4, out, out);  // same grid row as the pixel row above
+                continue;
+            }
+            cachedRow = cy;
+            for (int cx = cx0; cx <= cx1; cx++) cells[cx - cx0] = cellColor(layer, grid.index(cx, cy));
+            for (int x = 0; x < w; x++) {
+                const sf::Color &c = cells[(x0 + x) / cellPixels - cx0];
+                out[x * 4] = c.r;
+                out[x * 4 + 1] = c.g;
+                out[x * 4 + 2] = c.b;
+                out[x * 4 + 3] = c.a;
+            }
+        }
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef MEMORY_HPP_
+#define MEMORY_HPP_
+
+#include <SFML/Graphics.hpp>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Harvestor {
+enum MemorySubsystem { TileStorage = 0, RenderBuffers, ParticlePools, EvaluatorIndices, Caches, NumMemorySubsystems };
+
+// ---------------- MemoryReport ----------------
+// Bytes held per subsystem, filled in by each owner's reportMemory(). Containers count their
+// capacity, hash maps their buckets and nodes, textures the texels they keep on the GPU and vertex
+// arrays the vertices SFML keeps for them. Allocator headers are not counted, so the process uses
+// a little more than the total.
+class MemoryReport {
+   public:
+    struct Item {
+        MemorySubsystem subsystem;
+        std::string name;
+        std::size_t bytes;
+    };
+    std::vector<Item> items;
+    std::size_t tiles = 0;  // land tiles covered, for bytesPerTile()
+
+    static const char *name(MemorySubsystem subsystem) {
+        static const char *names[NumMemorySubsystems] = {"tile storage", "render buffers", "particle pools", "evaluator indices", "caches"};
+        return names[subsystem];
+    }
+
+    // Items of the same name add up, e.g. the tiles of every land
+    void add(MemorySubsystem subsystem, const std::string &name, std::size_t bytes) {
+        for (auto &item : items) {
+            if (item.subsystem == subsystem && item.name == name) {
+                item.bytes += bytes;
+                return;
+            }
+        }
+        items.push_back({subsystem, name, bytes});
+    }
+
+    std::size_t bytes(MemorySubsystem subsystem) const {
+        std::size_t sum = 0;
+        for (const auto &item : items)
+            if (item.subsystem == subsystem) sum += item.bytes;
+        return sum;
+    }
+
+    std::size_t total() const {
+        std::size_t sum = 0;
+        for (const auto &item : items) sum += item.bytes;
+        return sum;
+    }
+
+    double bytesPerTile() const { return tiles > 0 ? (double)total() / tiles : 0.0; }
+
+    void print(std::ostream &out, const std::string &title) const {
+        auto mb = [](std::size_t bytes) { return bytes / 1048576.0; };
+        out << title << ": " << std::fixed << std::setprecision(1) << mb(total()) << " MB for " << tiles << " tiles, " << std::setprecision(0)
+            << bytesPerTile() << " bytes per tile\n";
+        for (int s = 0; s < NumMemorySubsystems; s++) {
+            out << "  " << std::left << std::setw(20) << name((MemorySubsystem)s) << std::right << std::setprecision(2) << std::setw(10)
+                << mb(bytes((MemorySubsystem)s)) << " MB\n";
+            for (const auto &item : items)
+                if (item.subsystem == s && item.bytes > 0)
+                    out << "    " << std::left << std::setw(26) << item.name << std::right << std::setw(10) << mb(item.bytes) << " MB\n";
+        }
+        out << std::defaultfloat;
+    }
+
+    template <typename V>
+    static std::size_t vectorBytes(const V &v) {
+        return v.capacity() * sizeof(typename V::value_type);
+    }
+
+    // Bucket array plus one node (value, next pointer, cached hash) per element
+    template <typename M>
+    static std::size_t hashMapBytes(const M &m) {
+        return m.bucket_count() * sizeof(void *) + m.size() * (sizeof(typename M::value_type) + 2 * sizeof(void *));
+    }
+
+    static std::size_t textureBytes(const sf::Texture &texture) { return (std::size_t)texture.getSize().x * texture.getSize().y * 4; }
+    static std::size_t vertexBytes(const sf::VertexArray &vertices) { return vertices.getVertexCount() * sizeof(sf::Vertex); }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef MOISTURE_HPP_
+#define MOISTURE_HPP_
+
+#include "farmGrid.hpp"
+#include "parallel.hpp"
+
+namespace Harvestor {
+// ---------------- MoistureGrid ----------------
+// Lateral soil-moisture flow between neighbouring tiles: an explicit 5-point diffusion stencil on a
+// dense grid. Conductivity drops with compaction (flux between two cells uses the harmonic mean of
+// theirs, zero towards non-land cells) and compacted soil loses more water to evaporation.
+// The grid carries a one-cell border of dead cells so the sweep needs no bounds checks; each row
+// is a straight loop over flat arrays the compiler vectorizes. Work is split into blocks of
+// Config::moistureBlockRows x Config::moistureBlockCols cells, so the three rows a block reads stay
+// in cache, and blocks are spread over all cores.
+class MoistureGrid {
+   public:
+    int width = 0, height = 0;  // interior cells
+    int stride = 0;             // width + 2
+
+    MoistureGrid() = default;
+    MoistureGrid(int width, int height) { resize(width, height); }
+
+    // All cells dead (no land) and dry
+    void resize(int w, int h) {
+        width = w;
+        height = h;
+        stride = w + 2;
+        std::size_t n = (std::size_t)stride * (h + 2);
+        water.assign(n, 0.f);
+        next.assign(n, 0.f);
+        conductivity.assign(n, 0.f);
+        eastK.assign(n, 0.f);
+        southK.assign(n, 0.f);
+        loss.assign(n, 0.f);
+        maxRate = 0.f;
+    }
+
+    // Interior cell (x, y) in the padded arrays
+    std::size_t at(int x, int y) const { return (std::size_t)(y + 1) * stride + (x + 1); }
+
+    float &waterAt(int x, int y) { return water[at(x, y)]; }
+    float waterAt(int x, int y) const { return water[at(x, y)]; }
+
+    // Makes (x, y) a land cell with soil `compaction` (0..1)
+    void setSoil(int x, int y, float compaction) {
+        std::size_t i = at(x, y);
+        conductivity[i] = Config::moistureConductivity * (1.f - Config::moistureCompactionBlock * std::clamp(compaction, 0.f, 1.f));
+        loss[i] = Config::moistureEvaporation * (1.f + Config::moistureCompactionEvaporation * compaction);
+    }
+
+    // Face conductivities and the stable sub-step; call after the last setSoil
+    void finalize() {
+        auto face = [](float a, float b) { return a > 0.f && b > 0.f ? 2.f * a * b / (a + b) : 0.f; };
+        maxRate = 0.f;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                std::size_t i = at(x, y);
+                eastK[i] = face(conductivity[i], conductivity[i + 1]);
+                southK[i] = face(conductivity[i], conductivity[i + stride]);
+            }
+        }
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                std::size_t i = at(x, y);
+                maxRate = std::max(maxRate, eastK[i] + eastK[i - 1] + southK[i] + southK[i - stride] + loss[i]);
+            }
+        }
+    }
+
+    // Advances `dt` seconds, in as many sub-steps as explicit stability needs
+    void step(float dt) {
+        if (width == 0 || height == 0 || dt <= 0.f) return;
+        int substeps = std::max(1, (int)std::ceil(dt * maxRate / Config::moistureMaxCourant));
+        float h = dt / substeps;
+        for (int s = 0; s < substeps; s++) sweep(h);
+    }
+
+    // Sum of water over all cells
+    double total() const {
+        double sum = 0.0;
+        for (float w : water) sum += w;
+        return sum;
+    }
+
+    std::size_t bytes() const { return water.size() * sizeof(float) * 6; }
+
+   private:
+    std::vector<float> water, next;
+    std::vector<float> conductivity;  // per cell, 0 for dead cells
+    std::vector<float> eastK;         // flux conductivity between a cell and its east neighbour
+    std::vector<float> southK;        // ... and its south neighbour
+    std::vector<float> loss;          // evaporation per second, as a fraction of the cell's water
+    float maxRate = 0.f;              // largest sum of outgoing conductivities and loss
+
+    void sweep(float dt) {
+        int blockRows = std::max(1, Config::moistureBlockRows), blockCols = std::max(1, Config::moistureBlockCols);
+        int bandsY = (height + blockRows - 1) / blockRows, bandsX = (width + blockCols - 1) / blockCols;
+        parallelFor(
+            (std::size_t)bandsY * bandsX,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t b = begin; b < end; b++) {
+                    int y0 = (int)(b / bandsX) * blockRows, x0 = (int)(b % bandsX) * blockCols;
+                    int y1 = std::min(height, y0 + blockRows), x1 = std::min(width, x0 + blockCols);
+                    for (int y = y0; y < y1; y++) row(at(x0, y), x1 - x0, dt);
+                }
+            },
+            1);
+        water.swap(next);
+    }
+
+    // One row segment of `n` cells starting at padded index `i0`
+    void row(std::size_t i0, int n, float dt) {
+        const float *__restrict w = water.data() + i0;
+        const float *__restrict wN = w - stride;
+        const float *__restrict wS = w + stride;
+        const float *__restrict kE = eastK.data() + i0;
+        const float *__restrict kN = southK.data() + i0 - stride;
+        const float *__restrict kS = southK.data() + i0;
+        const float *__restrict e = loss.data() + i0;
+        float *__restrict out = next.data() + i0;
+        for (int x = 0; x < n; x++) {
+            float c = w[x];
+            float flux = kE[x] * (w[x + 1] - c) + kE[x - 1] * (w[x - 1] - c) + kS[x] * (wS[x] - c) + kN[x] * (wN[x] - c);
+            out[x] = c + dt * (flux - e[x] * c);
+        }
+    }
+};
+
+// ---------------- MoistureTransport ----------------
+// Runs MoistureGrid over the tiles of a farm: tile water is copied onto the grid cell by cell from
+// the FarmGrid's land mask, diffused, and copied back, keeping the running water stats in step.
+class MoistureTransport {
+   public:
+    // The layout (and so the FarmGrid) changed; the grid is rebuilt on the next step
+    void invalidate() { valid = false; }
+
+    void prepare(const FarmGrid &farm) {
+        if (valid) return;
+        valid = true;
+        grid.resize(farm.width, farm.height);
+        for (int y = 0; y < farm.height; y++) {
+            for (int x = 0; x < farm.width; x++) {
+                int i = farm.index(x, y);
+                if (farm.isLand(i)) grid.setSoil(x, y, farm.compaction[i]);
+            }
+        }
+        grid.finalize();
+    }
+
+    void step(std::vector<Land> &lands, const FarmGrid &farm, float dt) {
+        prepare(farm);
+        if (farm.landCells == 0) return;
+
+        for (int y = 0; y < farm.height; y++) {
+            for (int x = 0; x < farm.width; x++) {
+                int i = farm.index(x, y);
+                if (farm.isLand(i)) grid.waterAt(x, y) = lands[farm.landMask[i]].tiles[farm.tileIndex[i]].waterLevel;
+            }
+        }
+
+        grid.step(dt);
+
+        std::vector<double> delta(lands.size(), 0.0);
+        for (int y = 0; y < farm.height; y++) {
+            for (int x = 0; x < farm.width; x++) {
+                int i = farm.index(x, y);
+                if (!farm.isLand(i)) continue;
+                float &water = lands[farm.landMask[i]].tiles[farm.tileIndex[i]].waterLevel;
+                float old = water;
+                water = std::clamp(grid.waterAt(x, y), 0.f, 1.f);
+                delta[farm.landMask[i]] += water - old;
+            }
+        }
+        for (std::size_t l = 0; l < lands.size(); l++) {
+            lands[l].stats.waterSum += delta[l];
+            lands[l].markDirty();
+        }
+    }
+
+    std::size_t bytes() const { return grid.bytes(); }
+
+   private:
+    MoistureGrid grid;
+    bool valid = false;
+};
+
+}  // namespace Harvestor
+
+#endif
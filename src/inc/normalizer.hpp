@@ -45,6 +45,27 @@ struct Normalizer {
         offsetY = (screenH - (rangeY * scale)) / 2.f;
     }
 
+    // World-space mapping: one grid cell = cellSize world units, anchored at the grid origin so
+    // datasets sharing a grid (land.csv / water.csv) line up. The camera decides what is on screen.
+    // Independent of the screen, so headless runs never query the display.
+    Normalizer(const std::vector<sf::Vector2f> &positions, float cellSize) {
+        screenW = screenH = usableW = 0.f;
+
+        minX = minY = std::numeric_limits<float>::max();
+        maxX = maxY = std::numeric_limits<float>::lowest();
+        for (auto &p : positions) {
+            minX = std::min(minX, p.x);
+            minY = std::min(minY, p.y);
+            maxX = std::max(maxX, p.x);
+            maxY = std::max(maxY, p.y);
+        }
+        if (positions.empty()) minX = minY = maxX = maxY = 0.f;
+
+        scale = cellSize;
+        offsetX = minX * scale;
+        offsetY = minY * scale;
+    }
+
     sf::Vector2f normalize(const sf::Vector2f &p) const {
         float normX = (p.x - minX) * scale + offsetX;
         float normY = (p.y - minY) * scale + offsetY;
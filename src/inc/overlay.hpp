@@ -0,0 +1,126 @@
+#ifndef OVERLAY_HPP_
+#define OVERLAY_HPP_
+
+#include "config.hpp"
+
+namespace Harvestor {
+// ---------------- HeatmapOverlay ----------------
+// Heatmap modes drawn over the lands. Tile attributes live in small per-chunk textures, one texel
+// per tile (see Land::drawOverlay): a dynamic one (water, growth, soil quality, land/planted
+// mask), re-uploaded only when the chunk changes, and two static soil-factor ones baked once.
+// Picking the attribute, colormapping (a hue ramp in HSL), dimming and the pulse all happen in the
+// fragment shader, so switching modes or animating costs a few uniforms per visible chunk
+// whatever the tile count. SFML textures are 8 bits per channel, which is ample for a colormap.
+class HeatmapOverlay {
+   public:
+    // Which texture and channel a mode reads, and how it is colored
+    struct Mode {
+        const char *name;
+        int source;          // 0 dynamic, 1 soil factors A, 2 soil factors B
+        int channel;         // r, g, b, a
+        float hueLow, hueHigh;  // HSL hue (0..1) at value 0 and 1
+        bool invert;         // low raw values are good (compaction, salinity)
+        bool plantedOnly;    // unplanted tiles greyed out
+        float pulseBelow;    // values below pulse (0 = off)
+    };
+
+    static const std::vector<Mode> &modes() {
+        static const std::vector<Mode> list = {
+            {"Soil quality", 0, 2, 0.f, 1.f / 3.f, false, false, 0.f},    {"Water", 0, 0, 0.11f, 0.6f, false, false, 0.1f},
+            {"Growth", 0, 1, 0.f, 1.f / 3.f, false, true, 0.f},           {"Fertility", 1, 0, 0.f, 1.f / 3.f, false, false, 0.f},
+            {"Sunlight", 1, 1, 0.f, 1.f / 3.f, false, false, 0.f},        {"Nutrients", 1, 2, 0.f, 1.f / 3.f, false, false, 0.f},
+            {"pH", 1, 3, 0.f, 1.f / 3.f, false, false, 0.f},              {"Organic matter", 2, 0, 0.f, 1.f / 3.f, false, false, 0.f},
+            {"Compaction", 2, 1, 0.f, 1.f / 3.f, true, false, 0.f},       {"Salinity", 2, 2, 0.f, 1.f / 3.f, true, false, 0.f},
+        };
+        return list;
+    }
+
+    int mode = -1;  // index into modes(), -1 = off
+
+    bool active() const { return mode >= 0; }
+    const char *name() const { return active() ? modes()[mode].name : "Off"; }
+
+    // Off -> each mode in turn -> off
+    void cycle() {
+        mode = mode + 1 < (int)modes().size() ? mode + 1 : -1;
+        if (active() && !ready()) {
+            std::cerr << "Heatmap overlays need shader support\n";
+            mode = -1;
+        }
+    }
+
+    // Compiles the shader on first use (render thread); false if shaders are unavailable
+    bool ready() {
+        if (!loadAttempted) {
+            loadAttempted = true;
+            loaded = sf::Shader::isAvailable() && shader.loadFromMemory(fragmentSource, sf::Shader::Fragment);
+            if (!loaded) std::cerr << "Failed to compile the heatmap shader\n";
+        }
+        return loaded;
+    }
+
+    // Per-frame uniforms for the current mode; `seconds` drives the pulse
+    sf::Shader *begin(float seconds) {
+        if (!active() || !ready()) return nullptr;
+        const Mode &m = modes()[mode];
+        sf::Glsl::Vec4 pick(m.channel == 0, m.channel == 1, m.channel == 2, m.channel == 3);
+        shader.setUniform("texture", sf::Shader::CurrentTexture);
+        shader.setUniform("pick", pick);
+        shader.setUniform("source", m.source);
+        shader.setUniform("hueLow", m.hueLow);
+        shader.setUniform("hueHigh", m.hueHigh);
+        shader.setUniform("invert", m.invert ? 1.f : 0.f);
+        shader.setUniform("plantedOnly", m.plantedOnly ? 1.f : 0.f);
+        shader.setUniform("pulseBelow", m.pulseBelow);
+        shader.setUniform("opacity", Config::overlayOpacity);
+        shader.setUniform("time", seconds);
+        return &shader;
+    }
+
+    // The chunk's static soil-factor textures, before drawing its attribute sprite
+    void bindSoil(const sf::Texture &soilA, const sf::Texture &soilB) {
+        shader.setUniform("soilA", soilA);
+        shader.setUniform("soilB", soilB);
+    }
+
+   private:
+    sf::Shader shader;
+    bool loadAttempted = false, loaded = false;
+
+    static constexpr const char *fragmentSource = R"(
+uniform sampler2D texture;  // dynamic: r water, g growth, b soil quality, a 0 no tile / 0.5 land / 1 planted
+uniform sampler2D soilA;    // r fertility, g sunlight, b nutrients, a pH
+uniform sampler2D soilB;    // r organic matter, g compaction, b salinity
+uniform vec4 pick;          // one-hot channel of the source texture
+uniform int source;         // 0 texture, 1 soilA, 2 soilB
+uniform float hueLow, hueHigh;
+uniform float invert, plantedOnly, pulseBelow, opacity, time;
+
+vec3 hsl2rgb(vec3 c) {
+    vec3 rgb = clamp(abs(mod(c.x * 6.0 + vec3(0.0, 4.0, 2.0), 6.0) - 3.0) - 1.0, 0.0, 1.0);
+    return c.z + c.y * (rgb - 0.5) * (1.0 - abs(2.0 * c.z - 1.0));
+}
+
+void main() {
+    vec2 uv = gl_TexCoord[0].xy;
+    vec4 dyn = texture2D(texture, uv);
+    if (dyn.a < 0.25) discard;
+
+    vec4 src = dyn;
+    if (source == 1) src = texture2D(soilA, uv);
+    if (source == 2) src = texture2D(soilB, uv);
+    float v = dot(src, pick);
+    if (invert > 0.5) v = 1.0 - v;
+
+    float l = 0.5 - 0.1 * abs(v - 0.5);
+    if (v < pulseBelow) l += 0.15 * (0.5 + 0.5 * sin(time * 4.0));
+    vec3 color = hsl2rgb(vec3(mix(hueLow, hueHigh, v), 0.8, l));
+    if (plantedOnly > 0.5 && dyn.a < 0.75) color = vec3(0.35);
+    gl_FragColor = vec4(color, opacity);
+}
+)";
+};
+
+}  // namespace Harvestor
+
+#endif
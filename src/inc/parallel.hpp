@@ -0,0 +1,59 @@
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "config.hpp"
+
+namespace Harvestor {
+// ---------------- SerialScope ----------------
+// While one is alive, parallelFor on the same thread runs inline. For code that is already one of
+// several workers (BatchRunner's small farms), so nested kernels do not multiply the thread count.
+class SerialScope {
+    bool saved;
+
+    static bool &flag() {
+        thread_local bool serial = false;
+        return serial;
+    }
+
+   public:
+    SerialScope() : saved(flag()) { flag() = true; }
+    ~SerialScope() { flag() = saved; }
+    SerialScope(const SerialScope &) = delete;
+    SerialScope &operator=(const SerialScope &) = delete;
+
+    static bool active() { return flag(); }
+};
+
+// ---------------- parallelFor ----------------
+// Splits [0, n) into one contiguous range per thread (Config::threads, or one per core) and calls
+// fn(begin, end) on each; returns when all ranges are done. Small inputs (below `grain` items per
+// thread) stay on the calling thread, where spawning would cost more than the work, as does all
+// work under a SerialScope.
+template <typename Fn>
+void parallelFor(std::size_t n, Fn &&fn, std::size_t grain = 256) {
+    std::size_t threads = Config::threads > 0 ? (std::size_t)Config::threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, std::max<std::size_t>(1, n / std::max<std::size_t>(1, grain)));
+    if (SerialScope::active()) threads = 1;
+    if (threads <= 1) {
+        if (n > 0) fn(std::size_t(0), n);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    std::size_t per = (n + threads - 1) / threads;
+    for (std::size_t t = 1; t < threads; t++) {
+        std::size_t begin = std::min(n, t * per), end = std::min(n, begin + per);
+        if (begin < end) workers.emplace_back([&fn, begin, end]() { fn(begin, end); });
+    }
+    fn(std::size_t(0), std::min(n, per));
+    for (auto &w : workers) w.join();
+}
+
+}  // namespace Harvestor
+
+#endif
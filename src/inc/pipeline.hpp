@@ -0,0 +1,69 @@
+#ifndef PIPELINE_HPP_
+#define PIPELINE_HPP_
+
+#include <atomic>
+
+#include "config.hpp"
+
+namespace Harvestor {
+// ---------------- TripleBuffer ----------------
+// One writer publishes whole values, one reader picks up the latest; neither side blocks.
+// The writer fills writeBuffer() and calls publish(); the reader calls acquire() and then
+// reads readBuffer() until its next acquire(). Slots are reused, so vectors inside T keep
+// their capacity.
+template <typename T>
+class TripleBuffer {
+    static constexpr int kIndexMask = 0x3;
+    static constexpr int kFresh = 0x4;  // middle slot holds a value the reader has not seen
+
+    std::array<T, 3> slots;
+    std::atomic<int> middle{1};
+    int back = 0;   // writer only
+    int front = 2;  // reader only
+
+   public:
+    T &writeBuffer() { return slots[back]; }
+    void publish() { back = middle.exchange(back | kFresh, std::memory_order_acq_rel) & kIndexMask; }
+
+    // Returns true when a newer value was picked up
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & kIndexMask;
+        return true;
+    }
+    const T &readBuffer() const { return slots[front]; }
+};
+
+// ---------------- CommandQueue ----------------
+// Bounded single-producer / single-consumer ring buffer. Capacity must be a power of two.
+template <typename T, std::size_t Capacity>
+class CommandQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "CommandQueue capacity must be a power of two");
+
+    std::array<T, Capacity> items;
+    alignas(64) std::atomic<std::size_t> head{0};  // next slot to read, advanced by the consumer
+    alignas(64) std::atomic<std::size_t> tail{0};  // next slot to write, advanced by the producer
+
+   public:
+    // Producer side; false when the queue is full
+    bool push(const T &item) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false when the queue is empty
+    bool pop(T &item) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef RANDOM_HPP_
+#define RANDOM_HPP_
+
+#include <cstdint>
+
+#include "config.hpp"
+
+namespace Harvestor {
+// ---------------- RngStream ----------------
+// Independent random streams; each use site draws from its own so adding draws in one place
+// never shifts the numbers seen by another
+enum class RngStream : std::uint32_t { GrowthNoise = 1, SoilSamples, PondTint, BlobShape, RainDrops, Bench, CropPlanner, RainField, SoilNoise };
+
+// ---------------- Philox4x32 ----------------
+// Philox4x32-10 block function (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// Maps a 128-bit counter and a 64-bit key to 128 random bits; no state between calls.
+struct Philox4x32 {
+    static constexpr std::uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    static constexpr std::uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+    static std::array<std::uint32_t, 4> generate(std::array<std::uint32_t, 4> c, std::uint32_t k0, std::uint32_t k1) {
+        for (int round = 0; round < 10; round++) {
+            std::uint64_t p0 = (std::uint64_t)M0 * c[0];
+            std::uint64_t p1 = (std::uint64_t)M1 * c[2];
+            c = {(std::uint32_t)(p1 >> 32) ^ c[1] ^ k0, (std::uint32_t)p1, (std::uint32_t)(p0 >> 32) ^ c[3] ^ k1, (std::uint32_t)p0};
+            k0 += W0;
+            k1 += W1;
+        }
+        return c;
+    }
+};
+
+// ---------------- CounterRng ----------------
+// Random numbers as a pure function of (seed, stream, index, step): any tile's value for any step
+// can be computed on any thread in any order, and runs with the same seed are reproducible.
+class CounterRng {
+    std::uint32_t k0, k1;
+
+   public:
+    explicit CounterRng(RngStream stream, std::uint64_t seed = Config::seed)
+        : k0((std::uint32_t)seed), k1((std::uint32_t)(seed >> 32) ^ ((std::uint32_t)stream * Philox4x32::W1)) {}
+
+    std::array<std::uint32_t, 4> bits(std::uint64_t index, std::uint64_t step) const {
+        return Philox4x32::generate({(std::uint32_t)index, (std::uint32_t)(index >> 32), (std::uint32_t)step, (std::uint32_t)(step >> 32)}, k0,
+                                    k1);
+    }
+
+    // [0, 1) with 24 bits of resolution; `lane` picks one of the four words of the block
+    float uniform(std::uint64_t index, std::uint64_t step = 0, int lane = 0) const { return toUnit(bits(index, step)[lane & 3]); }
+    float uniform(float lo, float hi, std::uint64_t index, std::uint64_t step = 0, int lane = 0) const {
+        return lo + (hi - lo) * uniform(index, step, lane);
+    }
+
+    // [lo, hi] inclusive
+    int uniformInt(int lo, int hi, std::uint64_t index, std::uint64_t step = 0, int lane = 0) const {
+        std::uint32_t span = (std::uint32_t)(hi - lo) + 1u;
+        return lo + (int)(((std::uint64_t)bits(index, step)[lane & 3] * span) >> 32);
+    }
+
+    // out[i] = uniform(lo, hi, firstIndex + i, step) for i < n. Straight-line 32-bit lanes with no
+    // state carried between iterations, so the compiler vectorizes the loop.
+    void uniformBatch(float lo, float hi, std::uint64_t firstIndex, std::uint64_t step, float *__restrict out, std::size_t n) const {
+        while (n > 0) {
+            // Split where the low counter word wraps, so the high word is constant inside a run
+            std::uint32_t base = (std::uint32_t)firstIndex;
+            std::size_t run = std::min<std::uint64_t>(n, (std::uint64_t)UINT32_MAX - base + 1);
+            batchRun(lo, hi, base, (std::uint32_t)(firstIndex >> 32), step, out, run);
+            firstIndex += run;
+            out += run;
+            n -= run;
+        }
+    }
+
+    // Stable 64-bit index for a grid cell, so keyed draws do not depend on iteration order
+    static std::uint64_t cellKey(int x, int y) { return ((std::uint64_t)(std::uint32_t)y << 32) | (std::uint32_t)x; }
+
+   private:
+    void batchRun(float lo, float hi, std::uint32_t base, std::uint32_t high, std::uint64_t step, float *__restrict out, std::size_t n) const {
+        const std::uint32_t s0 = (std::uint32_t)step, s1 = (std::uint32_t)(step >> 32);
+        const float scale = (hi - lo) * (1.f / 16777216.f);
+        for (std::size_t i = 0; i < n; i++) {
+            std::uint32_t c0 = base + (std::uint32_t)i, c1 = high, c2 = s0, c3 = s1;
+            std::uint32_t a = k0, b = k1;
+            for (int round = 0; round < 10; round++) {
+                std::uint64_t p0 = (std::uint64_t)Philox4x32::M0 * c0;
+                std::uint64_t p1 = (std::uint64_t)Philox4x32::M1 * c2;
+                std::uint32_t n0 = (std::uint32_t)(p1 >> 32) ^ c1 ^ a, n1 = (std::uint32_t)p1;
+                std::uint32_t n2 = (std::uint32_t)(p0 >> 32) ^ c3 ^ b, n3 = (std::uint32_t)p0;
+                c0 = n0;
+                c1 = n1;
+                c2 = n2;
+                c3 = n3;
+                a += Philox4x32::W0;
+                b += Philox4x32::W1;
+            }
+            out[i] = lo + (float)(c0 >> 8) * scale;
+        }
+    }
+
+    static float toUnit(std::uint32_t v) { return (float)(v >> 8) * (1.f / 16777216.f); }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef REGION_HPP_
+#define REGION_HPP_
+
+#include "farmGrid.hpp"
+
+namespace Harvestor {
+// ---------------- Region ----------------
+// A world-space area to select tiles by: a rectangle, a circle or any simple polygon (concave
+// included, even-odd rule). spans() rasterizes it onto a FarmGrid row by row, so code working on a
+// field touches only the cells inside it instead of testing every tile. A rectangle covers every
+// cell it overlaps (like FarmGrid::cellsIn); circles and polygons cover the cells whose centre is
+// inside. The dense grid already answers "which tile is here" in O(1), so no spatial tree is needed.
+class Region {
+   public:
+    enum Shape { Rect, Circle, Polygon };
+
+    Shape shape = Rect;
+    std::vector<sf::Vector2f> points;  // Rect: top-left and bottom-right; Circle: centre; Polygon: vertices in order
+    float radius = 0.f;                // Circle
+
+    static Region rect(const sf::FloatRect &area) {
+        Region r;
+        r.points = {{area.left, area.top}, {area.left + area.width, area.top + area.height}};
+        return r;
+    }
+
+    static Region circle(const sf::Vector2f &centre, float radius) {
+        Region r;
+        r.shape = Circle;
+        r.points = {centre};
+        r.radius = radius;
+        return r;
+    }
+
+    static Region polygon(std::vector<sf::Vector2f> vertices) {
+        Region r;
+        r.shape = Polygon;
+        r.points = std::move(vertices);
+        return r;
+    }
+
+    bool empty() const {
+        switch (shape) {
+            case Rect: return points.size() < 2 || points[1].x <= points[0].x || points[1].y <= points[0].y;
+            case Circle: return points.empty() || radius <= 0.f;
+            default: return points.size() < 3;
+        }
+    }
+
+    sf::FloatRect bounds() const {
+        if (points.empty()) return {};
+        if (shape == Circle) return sf::FloatRect(points[0].x - radius, points[0].y - radius, 2.f * radius, 2.f * radius);
+        sf::Vector2f lo = points[0], hi = points[0];
+        for (const auto &p : points) {
+            lo = {std::min(lo.x, p.x), std::min(lo.y, p.y)};
+            hi = {std::max(hi.x, p.x), std::max(hi.y, p.y)};
+        }
+        return sf::FloatRect(lo, hi - lo);
+    }
+
+    bool contains(const sf::Vector2f &p) const {
+        if (empty()) return false;
+        switch (shape) {
+            case Rect: return p.x >= points[0].x && p.y >= points[0].y && p.x < points[1].x && p.y < points[1].y;
+            case Circle: {
+                sf::Vector2f d = p - points[0];
+                return d.x * d.x + d.y * d.y < radius * radius;
+            }
+            default: {
+                bool inside = false;
+                for (std::size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+                    const sf::Vector2f &a = points[i], &b = points[j];
+                    if ((a.y <= p.y) != (b.y <= p.y) && p.x < a.x + (p.y - a.y) * (b.x - a.x) / (b.y - a.y)) inside = !inside;
+                }
+                return inside;
+            }
+        }
+    }
+
+    // Closed outline for drawing; circles as `segments` points
+    std::vector<sf::Vector2f> outline(int segments = 48) const {
+        if (empty()) return {};
+        if (shape == Rect) return {points[0], {points[1].x, points[0].y}, points[1], {points[0].x, points[1].y}};
+        if (shape == Polygon) return points;
+        std::vector<sf::Vector2f> out(segments);
+        for (int i = 0; i < segments; i++) {
+            float a = 6.2831853f * i / segments;
+            out[i] = points[0] + radius * sf::Vector2f(std::cos(a), std::sin(a));
+        }
+        return out;
+    }
+
+    // Appends the x-intervals where the horizontal line at `y` is inside the region, as (begin, end)
+    // pairs in ascending order: one for a rectangle or circle, one per crossing pair of a polygon
+    void intervals(float y, std::vector<float> &out) const {
+        if (empty()) return;
+        switch (shape) {
+            case Rect:
+                if (y >= points[0].y && y < points[1].y) out.insert(out.end(), {points[0].x, points[1].x});
+                break;
+            case Circle: {
+                float dy = y - points[0].y;
+                if (dy * dy >= radius * radius) break;
+                float half = std::sqrt(radius * radius - dy * dy);
+                out.insert(out.end(), {points[0].x - half, points[0].x + half});
+                break;
+            }
+            default: {
+                std::size_t first = out.size();
+                for (std::size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+                    const sf::Vector2f &a = points[i], &b = points[j];
+                    if ((a.y <= y) != (b.y <= y)) out.push_back(a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y));
+                }
+                std::sort(out.begin() + first, out.end());
+            }
+        }
+    }
+
+    // Grid cells inside the region, clipped to the grid, sorted by row then column
+    std::vector<CellSpan> spans(const FarmGrid &grid) const {
+        std::vector<CellSpan> out;
+        if (empty()) return out;
+        sf::IntRect rows = grid.cellsIn(bounds());
+        if (rows.width == 0) return out;
+        if (shape == Rect) {
+            for (int y = rows.top; y < rows.top + rows.height; y++) out.push_back({y, rows.left, rows.left + rows.width});
+            return out;
+        }
+
+        // Cell x of row y is inside when its centre is: ((origin + x + 0.5) * cellSize, (origin + y + 0.5) * cellSize)
+        float cs = grid.cellSize;
+        auto firstCell = [&](float worldX) { return (int)std::ceil(worldX / cs - 0.5f) - grid.origin.x; };
+        auto push = [&](int y, int x0, int x1) {
+            x0 = std::max(x0, 0);
+            x1 = std::min(x1, grid.width);
+            if (x1 > x0) out.push_back({y, x0, x1});
+        };
+
+        // Scanline through the cell centres; each interval covers the centres in [begin, end)
+        std::vector<float> crossings;
+        for (int y = rows.top; y < rows.top + rows.height; y++) {
+            crossings.clear();
+            intervals((grid.origin.y + y + 0.5f) * cs, crossings);
+            for (std::size_t k = 0; k + 1 < crossings.size(); k += 2) push(y, firstCell(crossings[k]), firstCell(crossings[k + 1]));
+        }
+        return out;
+    }
+
+    static std::size_t cellCount(const std::vector<CellSpan> &spans) {
+        std::size_t n = 0;
+        for (const auto &s : spans) n += s.x1 - s.x0;
+        return n;
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
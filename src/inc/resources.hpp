@@ -0,0 +1,218 @@
+#ifndef RESOURCES_HPP_
+#define RESOURCES_HPP_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+
+#include "config.hpp"
+#include "memory.hpp"
+
+namespace Harvestor {
+// ---------------- TextureHandle ----------------
+// Stable name of a texture in the ResourceCache, valid for the life of the process. Cheap to copy
+// and to look up every frame; the texture behind it appears once it has been decoded and uploaded.
+struct TextureHandle {
+    static constexpr std::uint32_t none = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t id = none;
+
+    bool valid() const { return id != none; }
+};
+
+// ---------------- ResourceCache ----------------
+// Process-wide images, textures and fonts. Image files are decoded on background threads, one
+// decode per file however many textures are cut from it; the GPU upload happens on the main thread
+// in update(), once per frame. Until then a texture handle resolves to nullptr and callers draw
+// untextured. A decoded image is dropped once every texture requested from it is uploaded, and
+// uploaded textures live until exit, so reloading a layout never decodes anything. A file that
+// fails to load is reported once and not retried.
+// All members are called from the main (render) thread; only decoding runs elsewhere. Nothing is
+// loaded unless asked for, so headless runs never start a decode.
+class ResourceCache {
+   public:
+    // image size -> the part of the image a texture shows
+    using CropFn = std::function<sf::IntRect(sf::Vector2u)>;
+
+    static ResourceCache &get() {
+        static ResourceCache cache;
+        return cache;
+    }
+
+    // Starts decoding image files (or reading font files) that nothing has asked for yet, so the
+    // work overlaps window creation and scene setup
+    void prefetch(const std::vector<std::string> &imagePaths, const std::vector<std::string> &fontPaths = {}) {
+        for (auto &path : imagePaths) image(path);
+        for (auto &path : fontPaths) fontFile(path);
+    }
+
+    // The whole image file as a repeated, smoothed texture
+    TextureHandle request(const std::string &path) {
+        return request(path, "", nullptr);
+    }
+
+    // The part `crop` picks out of an image file whose size is not known yet; `cropName` tells
+    // crops of the same file apart
+    TextureHandle request(const std::string &path, const std::string &cropName, CropFn crop) {
+        std::string key = cropName.empty() ? path : path + "#" + cropName;
+        auto it = textureIds.find(key);
+        if (it != textureIds.end()) return {it->second};
+
+        TextureEntry entry;
+        entry.image = image(path);
+        ImageEntry &img = images[entry.image];
+        if (img.finished && !img.image && !img.failed) startDecode(img);  // dropped after an earlier upload
+        entry.crop = std::move(crop);
+        textures.push_back(std::move(entry));
+        images[textures.back().image].waiting++;
+        pending++;
+
+        TextureHandle handle{(std::uint32_t)(textures.size() - 1)};
+        textureIds.emplace(key, handle.id);
+        return handle;
+    }
+
+    // nullptr until the texture is uploaded, or for good if its file failed to load
+    const sf::Texture *texture(TextureHandle handle) const {
+        return handle.valid() && handle.id < textures.size() ? textures[handle.id].texture.get() : nullptr;
+    }
+
+    // Main thread, once per frame: collects finished decodes and uploads the textures waiting on them
+    void update() {
+        if (pending == 0) return;
+        for (auto &entry : textures) {
+            if (entry.done) continue;
+            ImageEntry &img = images[entry.image];
+            if (!img.ready()) continue;
+
+            if (img.image) {
+                sf::Vector2u size = img.image->getSize();
+                sf::IntRect area = entry.crop ? entry.crop(size) : sf::IntRect(0, 0, (int)size.x, (int)size.y);
+                auto tex = std::make_unique<sf::Texture>();
+                if (area.width > 0 && area.height > 0 && tex->loadFromImage(*img.image, area)) {
+                    tex->setRepeated(true);
+                    tex->setSmooth(true);
+                    entry.texture = std::move(tex);
+                    uploads++;
+                } else {
+                    std::cerr << "Failed to create texture from " << img.path << std::endl;
+                }
+            }
+            entry.done = true;
+            pending--;
+            if (--img.waiting == 0) img.image.reset();  // every texture of it is on the GPU
+        }
+    }
+
+    // Blocks until the file is read (usually long done when prefetched), then opens it into `font`.
+    // SFML reads glyphs from the bytes on demand; the cache keeps them alive.
+    bool loadFont(sf::Font &font, const std::string &path) {
+        FontFile &file = fontFile(path);
+        if (file.read.valid()) file.bytes = file.read.get();
+        if (file.bytes.empty() || !font.loadFromMemory(file.bytes.data(), file.bytes.size())) {
+            std::cerr << "Failed to load font from: " << path << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    int decodeCount() const { return decodes; }
+    int uploadCount() const { return uploads; }
+    bool idle() const { return pending == 0; }
+
+    // Uploaded textures, images decoded but not yet uploaded, and font files
+    void reportMemory(MemoryReport &report) const {
+        std::size_t gpu = 0, decoded = 0, fontBytes = 0;
+        for (const auto &entry : textures)
+            if (entry.texture) gpu += MemoryReport::textureBytes(*entry.texture);
+        for (const auto &img : images)
+            if (img.image) decoded += (std::size_t)img.image->getSize().x * img.image->getSize().y * 4;
+        for (const auto &font : fonts) fontBytes += font.second.bytes.capacity();
+        report.add(Caches, "textures (GPU)", gpu);
+        report.add(Caches, "decoded images", decoded);
+        report.add(Caches, "fonts", fontBytes);
+    }
+
+   private:
+    struct ImageEntry {
+        std::string path;
+        std::future<std::unique_ptr<sf::Image>> decoding;
+        std::unique_ptr<sf::Image> image;  // decoded, kept while textures wait on it
+        bool finished = false;
+        bool failed = false;
+        int waiting = 0;  // textures not yet uploaded
+
+        // Collects the decode result once it is in; never blocks
+        bool ready() {
+            if (!finished && decoding.valid() && decoding.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+                image = decoding.get();
+                finished = true;
+                failed = !image;
+            }
+            return finished;
+        }
+    };
+
+    struct TextureEntry {
+        std::size_t image = 0;  // index into images
+        CropFn crop;            // nullptr = whole image
+        std::unique_ptr<sf::Texture> texture;
+        bool done = false;      // uploaded or given up
+    };
+
+    struct FontFile {
+        std::future<std::vector<char>> read;
+        std::vector<char> bytes;
+    };
+
+    std::atomic<int> decodes{0};  // before the entries: decodes still running finish while they are destroyed
+    int uploads = 0;
+    std::deque<ImageEntry> images;
+    std::unordered_map<std::string, std::size_t> imageIds;
+    std::deque<TextureEntry> textures;
+    std::unordered_map<std::string, std::uint32_t> textureIds;
+    std::unordered_map<std::string, FontFile> fonts;
+    std::size_t pending = 0;  // textures not yet done
+
+    ResourceCache() = default;
+
+    // Index of the image entry for `path`, starting its decode if it is new
+    std::size_t image(const std::string &path) {
+        auto it = imageIds.find(path);
+        if (it != imageIds.end()) return it->second;
+        images.emplace_back();
+        images.back().path = path;
+        startDecode(images.back());
+        imageIds.emplace(path, images.size() - 1);
+        return images.size() - 1;
+    }
+
+    void startDecode(ImageEntry &img) {
+        img.finished = false;
+        img.decoding = std::async(std::launch::async, [this, path = img.path]() {
+            auto decoded = std::make_unique<sf::Image>();
+            if (!decoded->loadFromFile(path)) {
+                std::cerr << "Failed to load image " << path << std::endl;
+                return std::unique_ptr<sf::Image>();
+            }
+            decodes++;
+            return decoded;
+        });
+    }
+
+    FontFile &fontFile(const std::string &path) {
+        auto it = fonts.find(path);
+        if (it != fonts.end()) return it->second;
+        FontFile &file = fonts[path];
+        file.read = std::async(std::launch::async, [path]() {
+            std::ifstream in(path, std::ios::binary);
+            return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        });
+        return file;
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
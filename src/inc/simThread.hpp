@@ -0,0 +1,137 @@
+#ifndef SIM_THREAD_HPP_
+#define SIM_THREAD_HPP_
+
+#include <chrono>
+#include <thread>
+
+#include "pipeline.hpp"
+#include "simulation.hpp"
+
+namespace Harvestor {
+// ---------------- FrameSnapshot ----------------
+// Everything the render thread needs from one simulation step
+struct FrameSnapshot {
+    std::vector<LandSnapshot> lands;  // indexed like FarmScene::lands
+    LandStats stats;                  // farm-wide totals
+    float simTime = 0.f;              // seconds simulated since Start
+    bool simulating = false;
+    bool raining = false;
+    bool weatherActive = false;  // a weather series drives this step
+    WeatherSample weather;
+    std::uint64_t step = 0;
+    std::uint64_t seed = Config::seed;  // SimState::seed, for the render thread's own draws
+    std::uint64_t applied = 0;  // commands applied before this step (compare with SimThread::post tickets)
+    std::size_t workingBytes = 0;  // Simulation::workingBytes()
+};
+
+// ---------------- SimThread ----------------
+// Owns mutation of tile state while running: steps the Simulation at Config::simStepSeconds,
+// applies queued commands between steps and publishes a FrameSnapshot after each step. Structural
+// changes (loading a layout) must happen between stop() and start().
+class SimThread {
+    TripleBuffer<FrameSnapshot> snapshots;
+    CommandQueue<SimCommand, 256> commands;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::uint64_t posted = 0;  // render thread only
+
+    // Simulation thread only
+    Simulation sim;
+    std::uint64_t applied = 0;
+
+   public:
+    SimThread(std::vector<Land> &lands, std::vector<Pond> &ponds) : sim(lands, ponds) {}
+    ~SimThread() { stop(); }
+
+    void start() {
+        if (running) return;
+        sim.layoutChanged();
+        publish();
+        snapshots.acquire();  // render sees the new world right away
+        running = true;
+        worker = std::thread(&SimThread::run, this);
+    }
+
+    void stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+    }
+
+    // ---------------- Render thread side ----------------
+    // Returns a ticket; the command has taken effect once snapshot().applied >= ticket
+    std::uint64_t post(const SimCommand &command) {
+        if (!commands.push(command)) {
+            std::cerr << "Simulation command queue full, dropping command " << command.type << "\n";
+            return 0;
+        }
+        return ++posted;
+    }
+
+    // Picks up the latest published step; returns true if it is new
+    bool acquire() { return snapshots.acquire(); }
+    const FrameSnapshot &snapshot() const { return snapshots.readBuffer(); }
+
+    // Only rebuilt in start(), so the render thread may read it while the simulation runs
+    const FarmGrid &grid() const { return sim.grid; }
+
+    // Render thread: world storage, the three snapshot buffers (sized like the one last read) and
+    // the simulation's own scratch as of the last published step
+    void reportMemory(MemoryReport &report) const {
+        for (const auto &land : sim.lands) land.reportMemory(report);
+        for (const auto &pond : sim.ponds) pond.reportMemory(report);
+        sim.grid.reportMemory(report);
+        std::size_t visuals = 0;
+        for (const auto &land : snapshot().lands) visuals += MemoryReport::vectorBytes(land.tiles) + MemoryReport::vectorBytes(land.chunkVersions);
+        report.add(RenderBuffers, "frame snapshots", 3 * visuals);
+        report.add(Caches, "simulation scratch", snapshot().workingBytes);
+    }
+
+   private:
+    void run() {
+        using Clock = std::chrono::steady_clock;
+        auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(Config::simStepSeconds));
+        auto last = Clock::now();
+        auto next = last + period;
+
+        while (running) {
+            SimCommand command;
+            while (commands.pop(command)) {
+                sim.apply(command);
+                applied++;
+            }
+
+            auto now = Clock::now();
+            float dt = std::min(std::chrono::duration<float>(now - last).count(), Config::simMaxStepSeconds);
+            last = now;
+            sim.step(dt);
+            publish();
+
+            std::this_thread::sleep_until(next);
+            next = std::max(next + period, Clock::now());
+        }
+    }
+
+    void publish() {
+        FrameSnapshot &frame = snapshots.writeBuffer();
+        frame.lands.resize(sim.lands.size());
+        frame.stats = LandStats();
+        for (std::size_t i = 0; i < sim.lands.size(); i++) {
+            sim.lands[i].snapshot(frame.lands[i]);
+            frame.stats += sim.lands[i].stats;
+        }
+        frame.simTime = sim.state.simTime;
+        frame.simulating = sim.state.simulate;
+        frame.raining = sim.raining();
+        frame.weatherActive = sim.weather.active();
+        frame.weather = sim.weather.current();
+        frame.step = sim.state.step;
+        frame.seed = sim.state.seed;
+        frame.applied = applied;
+        frame.workingBytes = sim.workingBytes();
+        snapshots.publish();
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
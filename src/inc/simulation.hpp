@@ -0,0 +1,287 @@
+#ifndef SIMULATION_HPP_
+#define SIMULATION_HPP_
+
+#include <chrono>
+#include <memory>
+
+#include "checkpoint.hpp"
+#include "land.hpp"
+#include "moisture.hpp"
+#include "region.hpp"
+#include "weather.hpp"
+
+namespace Harvestor {
+// ---------------- SimCommand ----------------
+// UI requests for the simulation thread. Plain data so it can sit in a lock-free ring; a PlantArea
+// region is shared and never modified once posted.
+struct SimCommand {
+    enum Type { SetSimulate, StartRain, Reset, PlantArea, WriteOutput, SaveCheckpoint, RestoreCheckpoint, LoadWeather, SetDiffusion };
+    Type type;
+    bool enable = false;                   // SetSimulate, SetDiffusion; LoadWeather: load Config::weatherFile, or unload
+    CropId crop = kNoCrop;                 // PlantArea
+    std::shared_ptr<const Region> area{};  // PlantArea, world space
+};
+
+// ---------------- RegionRun ----------------
+// Steps only the tiles of a region, on a clock of its own that starts at the farm time it is
+// created with. Tiles outside are neither read nor written, so re-integrating a replanted field
+// costs its tiles rather than the farm's. Each tile draws the same variability as in a farm step
+// (keyed by tile and step), so without rain and diffusion, which couple a tile to the rest of the
+// farm, the result matches stepping the whole farm tile for tile.
+class RegionRun {
+    std::vector<Land> &lands;
+    std::vector<std::vector<int>> tiles;  // per land, ascending
+
+   public:
+    float time;          // farm time: start of the run plus the seconds stepped
+    std::uint64_t step;  // keys growth variability like SimState::step
+    std::uint64_t seed;  // and SimState::seed
+    std::size_t tileCount = 0;
+
+    RegionRun(std::vector<Land> &lands, const FarmGrid &grid, const std::vector<CellSpan> &spans, float time, std::uint64_t step,
+              std::uint64_t seed)
+        : lands(lands), tiles(lands.size()), time(time), step(step), seed(seed) {
+        grid.forEachTile(spans, [&](int l, int i) { tiles[l].push_back(i); });
+        for (auto &indices : tiles) {
+            std::sort(indices.begin(), indices.end());
+            tileCount += indices.size();
+        }
+    }
+
+    void advance(float dt, float climate = 1.f) {
+        time += dt;
+        for (std::size_t l = 0; l < lands.size(); l++) {
+            if (!tiles[l].empty()) lands[l].updateGrowth(tiles[l], dt, false, time, step, seed, climate);
+        }
+        step++;
+    }
+
+    LandStats stats() const {
+        LandStats out;
+        for (std::size_t l = 0; l < lands.size(); l++) {
+            for (int i : tiles[l]) out.add(lands[l].tiles[i]);
+        }
+        return out;
+    }
+
+    bool matured() const {
+        LandStats s = stats();
+        return s.maturedTiles == s.cropTiles;
+    }
+
+    // Mean seconds from planting to maturity over the matured tiles
+    float meanTimeToMature() const {
+        double sum = 0.0;
+        int count = 0;
+        for (std::size_t l = 0; l < lands.size(); l++) {
+            for (int i : tiles[l]) {
+                const Tile &tile = lands[l].tiles[i];
+                if (!tile.hasCrop || tile.timeToMature < 0.f) continue;
+                sum += tile.timeToMature;
+                count++;
+            }
+        }
+        return count > 0 ? (float)(sum / count) : 0.f;
+    }
+};
+
+// ---------------- Simulation ----------------
+// Tile state stepping and the commands that edit it, without any threading: SimThread drives it
+// at real-time pace, headless runs (see Headless) call step() in a loop.
+class Simulation {
+   public:
+    std::vector<Land> &lands;
+    std::vector<Pond> &ponds;
+    SimState state;
+    FarmGrid grid;  // dense cell view of lands and ponds, rebuilt by layoutChanged()
+    WeatherDriver weather;
+    MoistureTransport moisture;
+    bool diffusion = Config::moistureDiffusion;  // lateral moisture flow after each step
+    Checkpoint checkpoint;
+
+    Simulation(std::vector<Land> &lands, std::vector<Pond> &ponds) : lands(lands), ponds(ponds) {}
+
+    // Lands or ponds were replaced (call while nothing else reads them): rebuilds the FarmGrid and
+    // with it every tile's pond coverage
+    void layoutChanged() {
+        grid.build(lands, ponds);
+        grid.applyPondCoverage(lands);
+        moisture.invalidate();
+    }
+
+    // Growth scratch and moisture grid: the memory only the simulation thread touches
+    std::size_t workingBytes() const {
+        std::size_t bytes = moisture.bytes();
+        for (const auto &land : lands) bytes += land.scratchBytes();
+        return bytes;
+    }
+
+    // Single-threaded use (headless runs); SimThread::reportMemory reads the same while running
+    void reportMemory(MemoryReport &report) const {
+        for (const auto &land : lands) land.reportMemory(report);
+        for (const auto &pond : ponds) pond.reportMemory(report);
+        grid.reportMemory(report);
+        report.add(Caches, "simulation scratch", workingBytes());
+    }
+
+    void step(float dt) {
+        if (state.simulate) state.simTime += dt;
+        bool raining = state.rainRemaining > 0.f;
+        bool weatherActive = state.simulate && weather.update(state.simTime);
+        if (weatherActive) weather.apply(lands, dt, state.seed);
+        float climate = weatherActive ? weather.climateFactor() : 1.f;
+        for (auto &land : lands) land.updateGrowth(dt, state.simulate, raining, state.simTime, state.step, state.seed, climate);
+        if (raining) {
+            for (auto &land : lands) land.applyRainBoost(dt);  // locally boost water/growth for tiles
+            state.rainRemaining -= dt;
+        }
+        if (diffusion && state.simulate) moisture.step(lands, grid, dt);
+        state.step++;
+    }
+
+    bool raining() const { return state.rainRemaining > 0.f || (weather.active() && weather.current().rain > 0.f); }
+
+    void apply(const SimCommand &command) {
+        switch (command.type) {
+            case SimCommand::SetSimulate:
+                if (command.enable && !state.simulate) restartClock();
+                state.simulate = command.enable;
+                break;
+            case SimCommand::StartRain:
+                state.rainRemaining = Config::rainDuration;
+                break;
+            case SimCommand::Reset:
+                reset();
+                break;
+            case SimCommand::PlantArea:
+                if (command.area) plantArea(command.crop, *command.area);
+                break;
+            case SimCommand::WriteOutput:
+                writeOutput("simulation_output.csv");
+                break;
+            case SimCommand::SaveCheckpoint: {
+                auto start = std::chrono::steady_clock::now();
+                std::size_t written = checkpoint.save(Config::checkpointFile, lands, state);
+                float ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+                std::cout << "Checkpoint saved to " << Config::checkpointFile << ": " << written << " tiles written in " << ms << " ms\n";
+                break;
+            }
+            case SimCommand::RestoreCheckpoint:
+                if (checkpoint.restore(Config::checkpointFile, lands, state)) std::cout << "Checkpoint restored from " << Config::checkpointFile << "\n";
+                break;
+            case SimCommand::LoadWeather:
+                if (!command.enable)
+                    weather.unload();
+                else if (weather.load(Config::weatherFile))
+                    std::cout << "Weather series loaded from " << Config::weatherFile << "\n";
+                break;
+            case SimCommand::SetDiffusion:
+                diffusion = command.enable;
+                std::cout << "Moisture diffusion " << (diffusion ? "on" : "off") << "\n";
+                break;
+        }
+    }
+
+    // Plants `crop` (kNoCrop: each tile's current crop again) on the land tiles of `spans` at the
+    // current time, with growth reset and their own clocks restarted. Returns the tiles planted.
+    int replant(const std::vector<CellSpan> &spans, CropId crop) {
+        const CropRegistry &crops = CropRegistry::get();
+        int planted = 0;
+        std::vector<char> touched(lands.size(), 0);
+        grid.forEachTile(spans, [&](int l, int i) {
+            Land &land = lands[l];
+            Tile &tile = land.tiles[i];
+            CropId id = crop != kNoCrop ? crop : tile.cropId;
+            if (!crops.valid(id)) return;
+            land.stats.remove(tile);  // stats follow the region only, no rescan of the farm
+            tile.hasCrop = true;
+            tile.cropId = id;
+            tile.crop.growth = 0.f;
+            tile.crop.originalSize = sf::Vector2f(tile.size, tile.size);
+            tile.waterLevel = crops.optimalWater[id];
+            tile.soilQuality = land.computeSoilQuality(i, id);
+            tile.plantedAt = state.simTime;
+            tile.timeToMature = -1.f;
+            land.stats.add(tile);
+            touched[l] = 1;
+            planted++;
+        });
+        for (std::size_t l = 0; l < lands.size(); l++) {
+            if (touched[l]) lands[l].markDirty();
+        }
+        return planted;
+    }
+
+   private:
+    // Replants the grid cells inside `area` only; their clocks restart now and every other tile,
+    // planted or not, is left as it is
+    void plantArea(CropId chosenCrop, const Region &area) {
+        const CropRegistry &crops = CropRegistry::get();
+        if (!crops.valid(chosenCrop)) return;
+        int plantedCount = replant(area.spans(grid), chosenCrop);
+        std::cout << "Planted " << plantedCount << " crops of type " << crops.name(chosenCrop) << " in selection.\n";
+    }
+
+    // Start counts simulated time from zero again. Planting times move with it, so tiles already
+    // growing keep their age instead of starting over.
+    void restartClock() {
+        for (auto &land : lands) {
+            for (auto &tile : land.tiles) tile.plantedAt -= state.simTime;
+            land.markDirty();
+        }
+        state.simTime = 0.f;
+    }
+
+    void reset() {
+        state.simulate = false;
+        state.rainRemaining = 0.f;
+        state.simTime = 0.f;
+        for (auto &land : lands) {
+            for (auto &tile : land.tiles) {
+                tile.hasCrop = false;
+                tile.crop.growth = 0.f;
+                tile.waterLevel = 0.f;
+                tile.soilQuality = 0.f;
+                tile.plantedAt = 0.f;
+                tile.timeToMature = -1.f;
+            }
+            land.tilesChanged();
+        }
+    }
+
+    void writeOutput(const std::string &filename) {
+        std::ofstream out(filename, std::ios::app);  // <-- append mode
+        if (!out.is_open()) {
+            std::cerr << "Failed to open output file: " << filename << "\n";
+            return;
+        }
+
+        // Write header only if file is empty
+        static bool headerWritten = false;
+        if (!headerWritten) {
+            out << "LandIndex,TileX,TileY,CropName,Growth,TimeToMature,SoilQuality\n";
+            headerWritten = true;
+        }
+
+        const CropRegistry &crops = CropRegistry::get();
+        for (int landIdx = 0; landIdx < (int)lands.size(); ++landIdx) {
+            const auto &land = lands[landIdx];
+            for (const auto &tile : land.tiles) {
+                if (!tile.hasCrop) continue;
+                float maturity = (tile.timeToMature >= 0.f) ? tile.timeToMature : state.simTime - tile.plantedAt;
+                if (tile.crop.growth >= 1.f) {
+                    sf::Vector2i cell = ChunkIndex::cellOf(tile.position, land.tileSize);  // input/land.csv coordinates
+                    out << landIdx << "," << cell.x << "," << cell.y << "," << crops.name(tile.cropId) << "," << std::fixed
+                        << std::setprecision(2) << tile.crop.growth << "," << maturity << "," << tile.soilQuality << "\n";
+                }
+            }
+        }
+
+        out.close();
+        std::cout << "Simulation output appended to " << filename << "\n";
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef SOIL_HPP_
+#define SOIL_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "config.hpp"
+
+// Storage for per-tile soil factors: 32 = float, 16 / 8 = fixed point over [0, 1]
+#ifndef HARVESTOR_SOIL_BITS
+#define HARVESTOR_SOIL_BITS 32
+#endif
+
+namespace Harvestor {
+// ---------------- SoilSample ----------------
+// The seven soil factors of one tile (0..1), as read from land.csv
+struct SoilSample {
+    float soilBaseQuality = 0.f;  // fertility
+    float sunlight = 0.f;         // sunlight exposure
+    float nutrients = 0.f;        // nutrient richness
+    float pH = 0.f;               // acidity (normalized 0..1)
+    float organicMatter = 0.f;    // organic content
+    float compaction = 0.f;       // soil compactness
+    float salinity = 0.f;         // optional, extra factor
+};
+
+enum SoilFactor { SoilBase = 0, Sunlight, Nutrients, PH, OrganicMatter, Compaction, Salinity, NumSoilFactors };
+
+// ---------------- Soil quality weights ----------------
+// quality = weighted factors (compaction and salinity count as 1 - x) + water term, clamped to 0..1
+struct SoilWeights {
+    static constexpr float base = 0.25f;
+    static constexpr float sunlight = 0.15f;
+    static constexpr float nutrients = 0.15f;
+    static constexpr float pH = 0.1f;
+    static constexpr float organicMatter = 0.15f;
+    static constexpr float compaction = 0.1f;
+    static constexpr float salinity = 0.1f;
+    static constexpr float water = 0.1f;
+};
+
+inline float soilQuality(float staticQuality, float waterFactor) { return std::clamp(staticQuality + SoilWeights::water * waterFactor, 0.f, 1.f); }
+
+// ---------------- SoilCodec ----------------
+template <typename T>
+struct SoilCodec {  // fixed point: 0 -> 0.0, max -> 1.0
+    static constexpr float maxValue = (float)std::numeric_limits<T>::max();
+    static constexpr float scale = 1.f / maxValue;
+    static T encode(float v) { return (T)std::lround(std::clamp(v, 0.f, 1.f) * maxValue); }
+};
+
+template <>
+struct SoilCodec<float> {
+    static constexpr float scale = 1.f;
+    static float encode(float v) { return v; }
+};
+
+// ---------------- BasicSoilStore ----------------
+// Structure-of-arrays soil storage, one contiguous channel per factor, indexed like Land::tiles.
+// Channels are allocated from the memory resource given at construction (the layout's arena).
+template <typename T>
+class BasicSoilStore {
+   public:
+    using Codec = SoilCodec<T>;
+    std::array<std::pmr::vector<T>, NumSoilFactors> channels;
+
+    BasicSoilStore() = default;
+    explicit BasicSoilStore(std::pmr::memory_resource *memory) : BasicSoilStore(memory, std::make_index_sequence<NumSoilFactors>()) {}
+
+    std::size_t size() const { return channels[SoilBase].size(); }
+    std::size_t capacity() const { return channels[SoilBase].capacity(); }
+    std::size_t bytes() const { return size() * NumSoilFactors * sizeof(T); }
+    static constexpr std::size_t bytesPerTile() { return NumSoilFactors * sizeof(T); }
+
+    void clear() {
+        for (auto &c : channels) c.clear();
+    }
+
+    void reserve(std::size_t n) {
+        for (auto &c : channels) c.reserve(n);
+    }
+
+    void resize(std::size_t n) {
+        for (auto &c : channels) c.resize(n);
+    }
+
+    // Factor f of tiles [begin, begin + n) from values[0 .. n)
+    void store(std::size_t begin, SoilFactor f, const float *__restrict values, std::size_t n) {
+        T *__restrict out = channels[f].data() + begin;
+        for (std::size_t i = 0; i < n; i++) out[i] = Codec::encode(values[i]);
+    }
+
+    void push_back(const SoilSample &s) {
+        channels[SoilBase].push_back(Codec::encode(s.soilBaseQuality));
+        channels[Sunlight].push_back(Codec::encode(s.sunlight));
+        channels[Nutrients].push_back(Codec::encode(s.nutrients));
+        channels[PH].push_back(Codec::encode(s.pH));
+        channels[OrganicMatter].push_back(Codec::encode(s.organicMatter));
+        channels[Compaction].push_back(Codec::encode(s.compaction));
+        channels[Salinity].push_back(Codec::encode(s.salinity));
+    }
+
+    float get(std::size_t i, SoilFactor f) const { return (float)channels[f][i] * Codec::scale; }
+
+    SoilSample sample(std::size_t i) const {
+        return {get(i, SoilBase), get(i, Sunlight), get(i, Nutrients), get(i, PH), get(i, OrganicMatter), get(i, Compaction), get(i, Salinity)};
+    }
+
+    // Reorders to follow a tile permutation: new[i] = old[order[i]]. Gathers through one heap
+    // scratch channel and copies back, so arena-backed channels are not reallocated.
+    void permute(const std::vector<int> &order) {
+        std::vector<T> sorted(order.size());
+        for (auto &c : channels) {
+            for (std::size_t i = 0; i < order.size(); i++) sorted[i] = c[order[i]];
+            std::copy(sorted.begin(), sorted.end(), c.begin());
+        }
+    }
+
+    // Soil quality without the water term for tiles [begin, end), written to out[0 .. end - begin).
+    // Dequantization is folded into the weights, so the loop is a straight multiply-add over
+    // contiguous channels that the compiler vectorizes.
+    void staticQuality(std::size_t begin, std::size_t end, float *__restrict out) const {
+        const T *__restrict base = channels[SoilBase].data() + begin;
+        const T *__restrict sun = channels[Sunlight].data() + begin;
+        const T *__restrict nut = channels[Nutrients].data() + begin;
+        const T *__restrict ph = channels[PH].data() + begin;
+        const T *__restrict org = channels[OrganicMatter].data() + begin;
+        const T *__restrict comp = channels[Compaction].data() + begin;
+        const T *__restrict sal = channels[Salinity].data() + begin;
+
+        constexpr float s = Codec::scale;
+        constexpr float wBase = SoilWeights::base * s, wSun = SoilWeights::sunlight * s, wNut = SoilWeights::nutrients * s;
+        constexpr float wPh = SoilWeights::pH * s, wOrg = SoilWeights::organicMatter * s;
+        constexpr float wComp = SoilWeights::compaction * s, wSal = SoilWeights::salinity * s;
+        constexpr float bias = SoilWeights::compaction + SoilWeights::salinity;
+
+        std::size_t n = end - begin;
+        for (std::size_t i = 0; i < n; i++) {
+            out[i] = bias + wBase * (float)base[i] + wSun * (float)sun[i] + wNut * (float)nut[i] + wPh * (float)ph[i] + wOrg * (float)org[i] -
+                     wComp * (float)comp[i] - wSal * (float)sal[i];
+        }
+    }
+
+    float staticQuality(std::size_t i) const {
+        float q;
+        staticQuality(i, i + 1, &q);
+        return q;
+    }
+
+   private:
+    template <std::size_t... I>
+    BasicSoilStore(std::pmr::memory_resource *memory, std::index_sequence<I...>) : channels{((void)I, std::pmr::vector<T>(memory))...} {}
+};
+
+#if HARVESTOR_SOIL_BITS == 8
+using SoilValue = std::uint8_t;
+#elif HARVESTOR_SOIL_BITS == 16
+using SoilValue = std::uint16_t;
+#else
+using SoilValue = float;
+#endif
+using SoilStore = BasicSoilStore<SoilValue>;
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef SOIL_NOISE_HPP_
+#define SOIL_NOISE_HPP_
+
+#include "common.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+#include "soil.hpp"
+
+namespace Harvestor {
+// ---------------- SoilNoise ----------------
+// Spatially coherent soil: three latent fields of multi-octave gradient noise (fertility, drainage,
+// exposure) over cell coordinates, mixed into the seven soil factors with fixed weights, so that
+// neighbouring tiles are alike and e.g. nutrients follow organic matter while compaction opposes
+// it. Gradients come from an integer hash of the lattice point and the seed (RngStream::SoilNoise),
+// with no tables, so every lane of the kernel is independent straight-line code the compiler
+// vectorizes; fill() runs blocks of tiles on all threads and writes straight into a SoilStore.
+class SoilNoise {
+   public:
+    static constexpr int kLatents = 3;
+    static constexpr int kMaxOctaves = 8;
+    static constexpr std::size_t kBlock = 256;  // lanes per kernel pass
+
+    explicit SoilNoise(std::uint64_t seed = Config::seed) {
+        const CounterRng rng(RngStream::SoilNoise, seed);
+        key = rng.bits(0, 0)[0];
+        for (int k = 0; k < kLatents; k++) {
+            for (int o = 0; o < kMaxOctaves; o++) {
+                auto b = rng.bits(1 + k, o);  // a fractional shift per field and octave decorrelates them
+                shift[k][o] = sf::Vector2f((float)(b[0] >> 8) * (1.f / 4096.f), (float)(b[1] >> 8) * (1.f / 4096.f));
+            }
+        }
+        for (auto &row : mix) {
+            float norm = std::sqrt(row[0] * row[0] + row[1] * row[1] + row[2] * row[2]);
+            for (float &w : row) w /= norm;
+        }
+    }
+
+    // out[f][i] = factor f at cell (x[i], y[i]) for i < n; cell coordinates in grid units
+    void evaluate(const float *x, const float *y, std::size_t n, const std::array<float *, NumSoilFactors> &out) const {
+        const int octaves = std::clamp(Config::soilNoiseOctaves, 1, kMaxOctaves);
+        alignas(32) float latent[kLatents][kBlock];
+        for (std::size_t first = 0; first < n; first += kBlock) {
+            std::size_t m = std::min(kBlock, n - first);
+            for (int k = 0; k < kLatents; k++) {
+                float *__restrict acc = latent[k];
+                std::fill(acc, acc + m, 0.f);
+                float freq = 1.f / Config::soilNoiseFeatureCells, amp = 1.f, norm = 0.f;
+                for (int o = 0; o < octaves; o++) {
+                    octave(x + first, y + first, m, freq, amp, shift[k][o], acc);
+                    norm += amp;
+                    freq *= 2.f;
+                    amp *= Config::soilNoisePersistence;
+                }
+                const float scale = kLatentGain / norm;
+                for (std::size_t i = 0; i < m; i++) acc[i] *= scale;
+            }
+
+            for (int f = 0; f < NumSoilFactors; f++) {
+                const float w0 = mix[f][0] * kSpread, w1 = mix[f][1] * kSpread, w2 = mix[f][2] * kSpread;
+                const float *__restrict l0 = latent[0], *__restrict l1 = latent[1], *__restrict l2 = latent[2];
+                float *__restrict o = out[f] + first;
+                for (std::size_t i = 0; i < m; i++) o[i] = std::clamp(kMid + w0 * l0[i] + w1 * l1[i] + w2 * l2[i], 0.f, 1.f);
+            }
+        }
+    }
+
+    SoilSample sample(float cellX, float cellY) const {
+        std::array<float, NumSoilFactors> v;
+        std::array<float *, NumSoilFactors> out;
+        for (int f = 0; f < NumSoilFactors; f++) out[f] = &v[f];
+        evaluate(&cellX, &cellY, 1, out);
+        return {v[SoilBase], v[Sunlight], v[Nutrients], v[PH], v[OrganicMatter], v[Compaction], v[Salinity]};
+    }
+
+    // Soil of every tile, by its cell (position / tileSize); `soil` is resized to match
+    template <typename T>
+    void fill(const TileVector &tiles, float tileSize, BasicSoilStore<T> &soil) const {
+        soil.resize(tiles.size());
+        const float inv = 1.f / tileSize;
+        fillRange(tiles.size(), soil, [&](std::size_t i) { return tiles[i].position * inv; });
+    }
+
+    // Soil of a dense width x height grid, row-major: tile y * width + x is cell (x, y)
+    template <typename T>
+    void fillGrid(int width, int height, BasicSoilStore<T> &soil) const {
+        soil.resize((std::size_t)width * height);
+        fillRange(soil.size(), soil, [&](std::size_t i) { return sf::Vector2f((float)(i % width), (float)(i / width)); });
+    }
+
+   private:
+    // Mixing weights of the latent fields (fertility, drainage, exposure) per factor, normalized per row
+    float mix[NumSoilFactors][kLatents] = {
+        {0.8f, 0.3f, 0.2f},    // soilBaseQuality
+        {0.f, -0.3f, 1.f},     // sunlight
+        {0.8f, 0.2f, 0.f},     // nutrients
+        {-0.3f, 0.2f, 0.6f},   // pH
+        {0.9f, -0.4f, 0.f},    // organicMatter
+        {-0.6f, -0.6f, 0.2f},  // compaction
+        {-0.2f, -0.8f, 0.3f},  // salinity
+    };
+    static constexpr float kMid = 0.55f;        // factor at a latent value of 0
+    static constexpr float kSpread = 0.35f;     // factor change per unit of latent value
+    static constexpr float kLatentGain = 4.5f;  // fBm sums spread about 0.1; stretch them to about +-0.5
+
+    std::uint32_t key;
+    sf::Vector2f shift[kLatents][kMaxOctaves];
+
+    // acc[i] += amp * gradient noise at (x[i], y[i]) * freq + shift
+    void octave(const float *__restrict x, const float *__restrict y, std::size_t n, float freq, float amp, sf::Vector2f s,
+                float *__restrict acc) const {
+        const std::uint32_t k = key;
+        for (std::size_t i = 0; i < n; i++) {
+            float px = x[i] * freq + s.x, py = y[i] * freq + s.y;
+            int ix = (int)px, iy = (int)py;
+            ix -= px < (float)ix;  // floor for negative cells
+            iy -= py < (float)iy;
+            float tx = px - (float)ix, ty = py - (float)iy;
+
+            float g00 = grad(hash(ix, iy, k), tx, ty), g10 = grad(hash(ix + 1, iy, k), tx - 1.f, ty);
+            float g01 = grad(hash(ix, iy + 1, k), tx, ty - 1.f), g11 = grad(hash(ix + 1, iy + 1, k), tx - 1.f, ty - 1.f);
+            float u = fade(tx), v = fade(ty);
+            float a = g00 + u * (g10 - g00), b = g01 + u * (g11 - g01);
+            acc[i] += amp * (a + v * (b - a));
+        }
+    }
+
+    static std::uint32_t hash(int x, int y, std::uint32_t key) {
+        std::uint32_t h = ((std::uint32_t)x * 0x8da6b343u) ^ ((std::uint32_t)y * 0xd8163841u) ^ key;
+        h ^= h >> 16;
+        h *= 0x7feb352du;
+        h ^= h >> 15;
+        h *= 0x846ca68bu;
+        h ^= h >> 16;
+        return h;
+    }
+
+    // Dot of the lattice point's gradient (two 16-bit halves of the hash, each in [-1, 1]) with the offset
+    static float grad(std::uint32_t h, float dx, float dy) {
+        float gx = (float)(int)(h & 0xffffu) * (1.f / 32767.5f) - 1.f;
+        float gy = (float)(int)(h >> 16) * (1.f / 32767.5f) - 1.f;
+        return gx * dx + gy * dy;
+    }
+
+    static float fade(float t) { return t * t * t * (t * (t * 6.f - 15.f) + 10.f); }
+
+    // Tiles [0, n) in kBlock blocks on all threads; cellOf(i) gives the cell of tile i
+    template <typename T, typename CellOf>
+    void fillRange(std::size_t n, BasicSoilStore<T> &soil, CellOf cellOf) const {
+        parallelFor(
+            n,
+            [&](std::size_t begin, std::size_t end) {
+                alignas(32) float xs[kBlock], ys[kBlock], values[NumSoilFactors][kBlock];
+                std::array<float *, NumSoilFactors> out;
+                for (int f = 0; f < NumSoilFactors; f++) out[f] = values[f];
+                for (std::size_t first = begin; first < end; first += kBlock) {
+                    std::size_t m = std::min(kBlock, end - first);
+                    for (std::size_t i = 0; i < m; i++) {
+                        sf::Vector2f c = cellOf(first + i);
+                        xs[i] = c.x;
+                        ys[i] = c.y;
+                    }
+                    evaluate(xs, ys, m, out);
+                    for (int f = 0; f < NumSoilFactors; f++) soil.store(first, (SoilFactor)f, values[f], m);
+                }
+            },
+            4 * kBlock);
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
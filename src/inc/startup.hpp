@@ -0,0 +1,83 @@
+#ifndef STARTUP_HPP_
+#define STARTUP_HPP_
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+#include "config.hpp"
+
+namespace Harvestor {
+// ---------------- StartupProfile ----------------
+// Where the time from launch to the first frame goes. The main thread ends each startup phase with
+// mark(); work moved off the critical path (texture decodes, the layout scan) reports milestone()s
+// from wherever it completes. firstFrame() prints the breakdown once, against
+// Config::startupBudgetMs, and milestones arriving later are printed as they come.
+class StartupProfile {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    static StartupProfile &get() {
+        static StartupProfile profile;
+        return profile;
+    }
+
+    // The phase running since the previous mark (or launch) ends now and is called `phase`
+    void mark(const std::string &phase) {
+        std::lock_guard<std::mutex> lock(mutex);
+        double now = msSinceStart();
+        phases.push_back({phase, now - lastMark});
+        lastMark = now;
+    }
+
+    // Background work that finished now; thread-safe
+    void milestone(const std::string &what) {
+        std::lock_guard<std::mutex> lock(mutex);
+        double now = msSinceStart();
+        if (reported) {
+            std::ostringstream line;  // formatted apart, so std::cout keeps its own float format
+            line << "Startup: " << what << " " << std::fixed << std::setprecision(1) << now << " ms after launch\n";
+            std::cout << line.str();
+            return;
+        }
+        milestones.push_back({what, now});
+    }
+
+    // Call after the first window.display()
+    void firstFrame() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (reported) return;
+        reported = true;
+        double now = msSinceStart();
+        phases.push_back({"first frame", now - lastMark});
+
+        std::ostringstream report;
+        report << std::fixed << std::setprecision(1) << "Startup: " << now << " ms to first frame (budget " << Config::startupBudgetMs << " ms"
+               << (now > Config::startupBudgetMs ? ", OVER" : "") << ")\n";
+        for (auto &p : phases) report << "  " << std::left << std::setw(24) << p.name << std::right << std::setw(8) << p.ms << " ms\n";
+        for (auto &m : milestones) report << "  " << std::left << std::setw(24) << m.name << std::right << std::setw(8) << m.ms << " ms after launch, in the background\n";
+        std::cout << report.str();
+    }
+
+   private:
+    struct Entry {
+        std::string name;
+        double ms;
+    };
+
+    Clock::time_point start = Clock::now();
+    std::mutex mutex;
+    std::vector<Entry> phases, milestones;
+    double lastMark = 0.0;
+    bool reported = false;
+
+    StartupProfile() = default;
+
+    double msSinceStart() const { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef TILE_RASTER_HPP_
+#define TILE_RASTER_HPP_
+
+#include "farmGrid.hpp"
+
+namespace Harvestor {
+// ---------------- TileRaster ----------------
+// Land tiles of a whole farm grouped by the cell of a FarmGrid (CSR), so the tiles of a cell, its
+// neighbours or a window are found without scanning positions, duplicates of a cell included.
+// Geometry, the pond mask and pond coverage are the grid's own (its distance transform), so the
+// planners see exactly the water model the simulation steps with. The grid must outlive the raster.
+class TileRaster {
+   public:
+    struct TileRef {
+        int land;
+        int index;  // into Land::tiles
+    };
+
+    const FarmGrid &grid;
+    std::vector<int> cellStart;      // tiles of cell c are tiles[cellStart[c] .. cellStart[c + 1])
+    std::vector<TileRef> tiles;      // sorted by cell
+    std::vector<int> tileCell;       // grid cell of tiles[t]
+    std::vector<float> tileQuality;  // static soil quality of tiles[t]
+
+    TileRaster(const std::vector<Land> &lands, const FarmGrid &grid) : grid(grid) { build(lands); }
+
+    sf::Vector2f worldPosition(int cell) const { return grid.worldOf(cell % grid.width, cell / grid.width); }
+
+    // Steady-state time to maturity (seconds) of `crop` on a tile with the given static soil quality
+    // and pond `coverage`: water settles at coverage * optimal minus evaporation; no rain or noise
+    static float timeToMature(float staticQuality, float coverage, CropId crop) {
+        const CropRegistry &registry = CropRegistry::get();
+        float water = std::max(0.f, coverage * registry.optimalWater[crop] - Land::evaporationRate / Land::waterSpeed);
+        float rate = registry.growthRate(crop, soilQuality(staticQuality, Land::waterFactor(water, crop)), water);
+        return rate > 1.f / Config::maxTimeToMature ? 1.f / rate : Config::maxTimeToMature;
+    }
+
+   private:
+    // Counting sort of the tiles of `lands` by grid cell; tiles outside the grid are left out
+    void build(const std::vector<Land> &lands) {
+        std::vector<int> cellOf;
+        std::vector<TileRef> refs;
+        std::vector<float> quality, landQuality;
+        for (int l = 0; l < (int)lands.size(); l++) {
+            const Land &land = lands[l];
+            landQuality.resize(land.tiles.size());
+            land.soil.staticQuality(0, land.tiles.size(), landQuality.data());
+            for (int i = 0; i < (int)land.tiles.size(); i++) {
+                sf::Vector2i c = grid.gridOf(land.tiles[i].position);
+                if (!grid.inside(c.x, c.y)) continue;
+                cellOf.push_back(grid.index(c.x, c.y));
+                refs.push_back({l, i});
+                quality.push_back(landQuality[i]);
+            }
+        }
+
+        cellStart.assign(grid.cells() + 1, 0);
+        for (int c : cellOf) cellStart[c + 1]++;
+        for (std::size_t c = 0; c < grid.cells(); c++) cellStart[c + 1] += cellStart[c];
+        std::vector<int> next(cellStart.begin(), cellStart.end() - 1);
+        tiles.resize(refs.size());
+        tileCell.resize(refs.size());
+        tileQuality.resize(refs.size());
+        for (std::size_t t = 0; t < refs.size(); t++) {
+            int slot = next[cellOf[t]]++;
+            tiles[slot] = refs[t];
+            tileCell[slot] = cellOf[t];
+            tileQuality[slot] = quality[t];
+        }
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
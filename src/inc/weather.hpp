@@ -0,0 +1,242 @@
+#ifndef WEATHER_HPP_
+#define WEATHER_HPP_
+
+#include <deque>
+
+#include "land.hpp"
+
+namespace Harvestor {
+// ---------------- WeatherSample ----------------
+// One row of an hourly weather series
+struct WeatherSample {
+    float hour = 0.f;          // hours since the start of the series
+    float rain = 0.f;          // mm per hour
+    float temperature = 20.f;  // deg C
+    float solar = 0.f;         // W/m^2
+};
+
+// ---------------- WeatherStream ----------------
+// Streams an hourly series "hour,rain_mm,temp_c,solar_wm2" (header line optional, hours ascending).
+// Only a lookahead window of Config::weatherLookahead rows is held in memory; rows behind the
+// current time are dropped as the simulation moves on, so a season of any length streams through.
+class WeatherStream {
+    std::string path;
+    std::ifstream file;
+    std::deque<WeatherSample> buffer;  // lookahead, oldest first
+    bool eof = true;
+    std::size_t line = 0;
+
+   public:
+    bool open(const std::string &filename) {
+        path = filename;
+        return rewind();
+    }
+
+    void close() {
+        file.close();
+        buffer.clear();
+        eof = true;
+    }
+
+    bool isOpen() const { return file.is_open() || !buffer.empty(); }
+
+    // Weather at `hour`, linear between rows. Returns false once `hour` is past the last row.
+    bool at(double hour, WeatherSample &out) {
+        if (!buffer.empty() && hour < buffer.front().hour && !rewind()) return false;  // time went back (reset, restore)
+        for (;;) {
+            if (buffer.size() < 2 && !eof) refill();
+            if (buffer.empty()) return false;
+            if (buffer.size() == 1) {
+                if (hour > buffer.front().hour) return false;
+                out = buffer.front();
+                return true;
+            }
+            if (hour <= buffer[1].hour) break;
+            buffer.pop_front();
+        }
+
+        const WeatherSample &a = buffer[0], &b = buffer[1];
+        float t = b.hour > a.hour ? std::clamp((float)(hour - a.hour) / (b.hour - a.hour), 0.f, 1.f) : 0.f;
+        out.hour = (float)hour;
+        out.rain = a.rain + (b.rain - a.rain) * t;
+        out.temperature = a.temperature + (b.temperature - a.temperature) * t;
+        out.solar = a.solar + (b.solar - a.solar) * t;
+        return true;
+    }
+
+   private:
+    bool rewind() {
+        file.close();
+        file.clear();
+        buffer.clear();
+        line = 0;
+        file.open(path);
+        eof = !file.is_open();
+        if (eof) {
+            std::cerr << "Failed to open weather file: " << path << "\n";
+            return false;
+        }
+        refill();
+        return true;
+    }
+
+    void refill() {
+        std::string text;
+        while ((int)buffer.size() < Config::weatherLookahead && std::getline(file, text)) {
+            line++;
+            if (text.empty() || text[0] == '#') continue;
+            const char *p = text.c_str();
+            char *end;
+            WeatherSample s;
+            float *fields[4] = {&s.hour, &s.rain, &s.temperature, &s.solar};
+            int parsed = 0;
+            for (; parsed < 4; parsed++) {
+                *fields[parsed] = std::strtof(p, &end);
+                if (end == p) break;
+                p = end;
+                while (*p == ',' || *p == ' ' || *p == '\t') p++;
+            }
+            if (parsed < 4) {
+                if (line > 1) std::cerr << "Invalid weather line " << line << ": " << text << "\n";  // line 1 may be a header
+                continue;
+            }
+            if (!buffer.empty() && s.hour <= buffer.back().hour) {
+                std::cerr << "Weather hours must ascend, skipping line " << line << "\n";
+                continue;
+            }
+            buffer.push_back(s);
+        }
+        if (!file) eof = true;
+    }
+};
+
+// ---------------- RainField ----------------
+// Spatial rain multiplier with mean 1: value noise on a lattice of Config::rainFieldCellTiles tiles,
+// redrawn every weather hour (blended between hours) and drifting with Config::rainFieldDrift.
+// Per chunk, the few lattice values it covers are drawn once; the per-tile pass is then a
+// branch-free bilinear blend over flat arrays.
+class RainField {
+    std::vector<float> lattice;  // window of lattice values for one chunk, time-blended
+    std::vector<float> fx, fy;   // per tile: lattice coordinates relative to the window
+    std::vector<int> base;       // per tile: index of the top-left lattice value
+
+   public:
+    // out[i] = multiplier for tiles[begin + i] at `hour`
+    void chunkFactors(const TileVector &tiles, float tileSize, int begin, int end, double hour, std::uint64_t seed, float *__restrict out) {
+        const CounterRng rng(RngStream::RainField, seed);
+        int n = end - begin;
+        float cell = Config::rainFieldCellTiles * tileSize;
+        float driftX = (float)(Config::rainFieldDrift.x * hour), driftY = (float)(Config::rainFieldDrift.y * hour);
+
+        // Lattice window covering the chunk
+        fx.resize(n);
+        fy.resize(n);
+        base.resize(n);
+        float minX = std::numeric_limits<float>::max(), minY = minX, maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+        for (int i = 0; i < n; i++) {
+            fx[i] = (tiles[begin + i].position.x + tileSize / 2.f) / cell - driftX;
+            fy[i] = (tiles[begin + i].position.y + tileSize / 2.f) / cell - driftY;
+            minX = std::min(minX, fx[i]);
+            minY = std::min(minY, fy[i]);
+            maxX = std::max(maxX, fx[i]);
+            maxY = std::max(maxY, fy[i]);
+        }
+        int x0 = (int)std::floor(minX), y0 = (int)std::floor(minY);
+        int w = (int)std::floor(maxX) - x0 + 2, h = (int)std::floor(maxY) - y0 + 2;
+
+        std::uint64_t h0 = (std::uint64_t)std::max(0.0, std::floor(hour));
+        float t = (float)(hour - std::floor(hour));
+        lattice.resize((std::size_t)w * h);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                std::uint64_t key = CounterRng::cellKey(x0 + x, y0 + y);
+                float a = rng.uniform(key, h0), b = rng.uniform(key, h0 + 1);
+                lattice[y * w + x] = a + (b - a) * t;
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            int ix = (int)std::floor(fx[i]), iy = (int)std::floor(fy[i]);
+            fx[i] -= (float)ix;
+            fy[i] -= (float)iy;
+            base[i] = (iy - y0) * w + (ix - x0);
+        }
+
+        // Bilinear blend, noise 0..1 mapped to 1 +- variation
+        const float *__restrict v = lattice.data();
+        const float amp = 2.f * Config::rainFieldVariation, bias = 1.f - Config::rainFieldVariation;
+        for (int i = 0; i < n; i++) {
+            int b = base[i];
+            float top = v[b] + (v[b + 1] - v[b]) * fx[i];
+            float bottom = v[b + w] + (v[b + w + 1] - v[b + w]) * fx[i];
+            out[i] = bias + amp * (top + (bottom - top) * fy[i]);
+        }
+    }
+};
+
+// ---------------- WeatherDriver ----------------
+// Feeds a weather series into the simulation at simulated time: spatial rain and temperature-driven
+// evaporation go into tile water, and temperature and sunlight scale growth (climateFactor).
+// One weather hour lasts Config::weatherHourSeconds of simulated time.
+class WeatherDriver {
+    WeatherStream stream;
+    RainField field;
+    std::vector<float> rainScratch;
+    WeatherSample weather;
+    bool loaded = false, valid = false;
+
+   public:
+    bool load(const std::string &filename) {
+        loaded = stream.open(filename);
+        valid = false;
+        return loaded;
+    }
+
+    void unload() {
+        stream.close();
+        loaded = valid = false;
+    }
+
+    bool isLoaded() const { return loaded; }
+    bool active() const { return valid; }  // a sample covers the current time
+    const WeatherSample &current() const { return weather; }
+
+    // Moves to `simTime`; returns false when no series is loaded or it has run out
+    bool update(float simTime) {
+        valid = loaded && stream.at(simTime / Config::weatherHourSeconds, weather);
+        return valid;
+    }
+
+    // Growth multiplier for the current hour: bell curve around the optimal temperature times
+    // sunlight, with Config::weatherNightGrowth left when it is dark
+    float climateFactor() const {
+        if (!valid) return 1.f;
+        float dt = (weather.temperature - Config::weatherOptimalTemp) / Config::weatherTempTolerance;
+        float temperature = std::clamp(1.f - dt * dt, 0.f, 1.f);
+        float light = std::clamp(weather.solar / Config::weatherReferenceSolar, 0.f, 1.f);
+        return temperature * (Config::weatherNightGrowth + (1.f - Config::weatherNightGrowth) * light);
+    }
+
+    // Rain (spatially varying) and heat evaporation on every tile for a step of `dt` seconds
+    void apply(std::vector<Land> &lands, float dt, std::uint64_t seed) {
+        if (!valid) return;
+        float rain = weather.rain * Config::weatherWaterPerMm / Config::weatherHourSeconds;  // water per second at multiplier 1
+        float evaporation = Config::weatherEvaporationPerDegree * std::max(0.f, weather.temperature - Config::weatherOptimalTemp);
+        if (rain <= 0.f && evaporation <= 0.f) return;
+        for (auto &land : lands) {
+            for (auto &chunk : land.chunks) {
+                int n = chunk.range.end - chunk.range.begin;
+                rainScratch.resize(n);
+                if (rain > 0.f)
+                    field.chunkFactors(land.tiles, land.tileSize, chunk.range.begin, chunk.range.end, weather.hour, seed, rainScratch.data());
+                else
+                    std::fill(rainScratch.begin(), rainScratch.end(), 0.f);
+                land.applyWater(chunk, rainScratch.data(), rain * dt, evaporation * dt);
+            }
+        }
+    }
+};
+
+}  // namespace Harvestor
+
+#endif
@@ -1,10 +1,110 @@
+#include "batch.hpp"
+#include "bench.hpp"
+#include "headless.hpp"
 #include "farmscene.hpp"
 
 using namespace Harvestor;
 
 // ---------------- Main ----------------
-int main() {
-    srand(static_cast<unsigned>(time(nullptr)));
+int main(int argc, char **argv) {
+    StartupProfile &startup = StartupProfile::get();  // startup clock starts here
+
+    // --seed N fixes every random stream; --threads N caps parallel kernels; --diffusion turns on moisture flow;
+    // --season [weather.csv] [crop] runs a weather season headless, --export DIR then writes its map PNGs;
+    // --what-if CROP X Y W H replants those input cells from checkpoint.bin and simulates only them;
+    // --batch MANIFEST [OUT] runs a season on every farm of the manifest, one CSV row each (resumable);
+    // --gen-soil W H OUT writes a land.csv of coherent generated soil;
+    // --mem-report [layout.txt | W H] prints memory per subsystem, or the estimate for a W x H all-land grid;
+    // benchmarks: --bench-soil|--bench-checkpoint|--bench-rng|--bench-irrigation|--bench-planner|--bench-moisture|--bench-distance|--bench-export|--bench-soil-noise [count]
+    bool season = false;
+    std::string weatherFile = Config::weatherFile, seasonCrop;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        int tiles = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+        if (arg == "--seed" && i + 1 < argc) {
+            Config::seed = std::strtoull(argv[++i], nullptr, 10);
+            continue;
+        }
+        if (arg == "--threads" && i + 1 < argc) {
+            Config::threads = std::atoi(argv[++i]);
+            continue;
+        }
+        if (arg == "--diffusion") {
+            Config::moistureDiffusion = true;
+            continue;
+        }
+        if (arg == "--export" && i + 1 < argc) {
+            Config::exportDir = argv[++i];
+            continue;
+        }
+        if (arg == "--season") {
+            season = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') weatherFile = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') seasonCrop = argv[++i];
+            continue;
+        }
+        if (arg == "--batch" && i + 1 < argc) {
+            std::string output = (i + 2 < argc && argv[i + 2][0] != '-') ? argv[i + 2] : Config::batchOutput;
+            return BatchRunner().run(argv[i + 1], output);
+        }
+        if (arg == "--gen-soil" && i + 3 < argc) {
+            return Headless::generateSoil(std::atoi(argv[i + 1]), std::atoi(argv[i + 2]), argv[i + 3]);
+        }
+        if (arg == "--mem-report") {
+            bool grid = i + 2 < argc && std::isdigit((unsigned char)argv[i + 1][0]) && std::isdigit((unsigned char)argv[i + 2][0]);
+            if (!grid) return Headless::memoryReport(i + 1 < argc && argv[i + 1][0] != '-' ? argv[i + 1] : "");
+            int w = std::atoi(argv[i + 1]), h = std::atoi(argv[i + 2]);
+            Headless::estimateMemory(w, h, (std::size_t)w * h, 0).print(std::cout, "Estimate for " + std::to_string(w) + "x" + std::to_string(h) + " land tiles");
+            return 0;
+        }
+        if (arg == "--what-if" && i + 5 < argc) {
+            sf::IntRect cells(std::atoi(argv[i + 2]), std::atoi(argv[i + 3]), std::atoi(argv[i + 4]), std::atoi(argv[i + 5]));
+            return Headless::whatIf(argv[i + 1], cells);
+        }
+        if (arg == "--bench-soil") {
+            Bench::soilStorage(tiles > 0 ? tiles : 1 << 22);
+            return 0;
+        }
+        if (arg == "--bench-checkpoint") {
+            Bench::checkpoint(tiles > 0 ? tiles : 1000000);
+            return 0;
+        }
+        if (arg == "--bench-rng") {
+            Bench::counterRng(tiles > 0 ? tiles : 1 << 22);
+            return 0;
+        }
+        if (arg == "--bench-irrigation") {
+            Bench::irrigation(tiles > 0 ? tiles : 100000);
+            return 0;
+        }
+        if (arg == "--bench-planner") {
+            Bench::cropPlanner(tiles > 0 ? tiles : 100000);
+            return 0;
+        }
+        if (arg == "--bench-export") {
+            Bench::mapExport(tiles > 0 ? tiles : 4096);
+            return 0;
+        }
+        if (arg == "--bench-distance") {
+            Bench::distanceField(tiles > 0 ? tiles : 2048);
+            return 0;
+        }
+        if (arg == "--bench-soil-noise") {
+            Bench::soilNoise(tiles > 0 ? tiles : 1 << 24);
+            return 0;
+        }
+        if (arg == "--bench-moisture") {
+            Bench::moisture(tiles);
+            return 0;
+        }
+    }
+    if (season) return Headless::season(weatherFile, seasonCrop);
+
+    // Decode textures and read the font in the background while the window and scene come up
+    ResourceCache::get().prefetch({Config::groundTexturePath, Config::waterTexturePath, Config::wheatTexturePath, Config::tomatoTexturePath,
+                                   Config::sugarcaneTexturePath},
+                                  {Config::fontPath});
+    startup.mark("resource prefetch");
 
     // Get screen resolution
     sf::VideoMode desktop = sf::VideoMode::getDesktopMode();
@@ -20,10 +120,12 @@ int main() {
     // Create window
     sf::RenderWindow window(sf::VideoMode((unsigned)width, (unsigned)height), "Farm Simulation");
     window.setFramerateLimit(60);
+    startup.mark("window");
 
     // Initialize managers
-    GrassManager grassManager("resources/combined.png", Config::grassTileSize);
+    GrassManager grassManager(Config::groundTexturePath, Config::grassTileSize);
     FarmScene farm(window, grassManager, width, height);
+    bool texturesReady = false;
 
     // Clock for delta time
     sf::Clock clock;
@@ -37,6 +139,7 @@ int main() {
             // Mouse pressed
             else if (event.type == sf::Event::MouseButtonPressed) {
                 if (event.mouseButton.button == sf::Mouse::Right) {
+                    farm.beginPan(sf::Mouse::getPosition(window));
                 } else if (event.mouseButton.button == sf::Mouse::Left) {
                     farm.handleMousePressed(sf::Mouse::getPosition(window));
                     farm.handleClick(sf::Mouse::getPosition(window));
@@ -51,9 +154,9 @@ int main() {
                 farm.handleMouseMoved(sf::Mouse::getPosition(window));
             }
 
-            // Mouse wheel scroll (dropdowns)
+            // Mouse wheel scroll (dropdowns, camera zoom)
             else if (event.type == sf::Event::MouseWheelScrolled) {
-                farm.handleMouseWheelScroll(event.mouseWheelScroll.delta);
+                farm.handleMouseWheelScroll(event.mouseWheelScroll.delta, sf::Vector2i(event.mouseWheelScroll.x, event.mouseWheelScroll.y));
             }
 
             // Keyboard events
@@ -63,9 +166,28 @@ int main() {
                 if (event.key.code == sf::Keyboard::C) {
                     farm.clearSelection();
                 }
+
+                if (event.key.code == sf::Keyboard::Home) {
+                    farm.fitCameraToWorld();  // Show the whole farm
+                }
+
+                if (event.key.code == sf::Keyboard::W) farm.toggleWeather();
+                if (event.key.code == sf::Keyboard::D) farm.toggleDiffusion();
+                if (event.key.code == sf::Keyboard::O) farm.cycleOverlay();
+                if (event.key.code == sf::Keyboard::L) farm.cycleSelectionShape();
+
+                if (event.key.code == sf::Keyboard::F5) farm.saveCheckpoint();
+                if (event.key.code == sf::Keyboard::F9) farm.restoreCheckpoint();
             }
         }
 
+        // Upload textures decoded since the last frame
+        ResourceCache::get().update();
+        if (!texturesReady && ResourceCache::get().idle()) {
+            texturesReady = true;
+            startup.milestone("textures uploaded");
+        }
+
         // Update simulation
         float dt = clock.restart().asSeconds();
         farm.update(dt);
@@ -74,6 +196,7 @@ int main() {
         window.clear(sf::Color(50, 50, 50));
         farm.draw();  // Draw farm & UI
         window.display();
+        startup.firstFrame();  // prints the startup breakdown once
     }
 
     return 0;